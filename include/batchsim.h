@@ -0,0 +1,79 @@
+#ifndef _BATCHSIM_H
+#define _BATCHSIM_H
+
+#include <cstddef>
+#include <vector>
+
+#include "simulation.h"
+#include "jobsystem.h"
+
+// Execução de N partidas independentes ao mesmo tempo, para treinar e avaliar
+// agentes automáticos. Cada chamada de BatchSim_Step() avança todas as
+// partidas um passo de simulação, dividindo-as em blocos executados pelas
+// threads de um sistema de tarefas ("jobsystem.h").
+//
+// As entradas e saídas ficam em vetores contíguos (um elemento, ou um bloco de
+// BATCHSIM_OBS_SIZE floats, por partida), que podem ser copiados diretamente
+// para o código de treinamento.
+//
+// Somente esses vetores de entrada e saída são "structure of arrays" entre as
+// partidas. O estado de cada partida continua sendo um GameState completo
+// (com as entidades em SoA dentro dele), avançado por Sim_Step(): intercalar
+// os campos de todas as partidas exigiria uma segunda implementação de todas
+// as regras do jogo, e cada partida tem poucas entidades, então o trabalho de
+// um passo fica dentro dos vetores de uma única partida, já na cache da thread
+// que a avança.
+
+// Bits de BatchSim::actions
+#define BATCHSIM_FORWARD 1
+#define BATCHSIM_LEFT    2
+#define BATCHSIM_RIGHT   4
+#define BATCHSIM_FIRE    8
+
+// Número de entidades mais próximas da nave incluídas na observação
+#define BATCHSIM_NEAREST_ENEMIES     3
+#define BATCHSIM_NEAREST_ASTEROIDS   3
+#define BATCHSIM_NEAREST_CHECKPOINTS 2
+
+// Observação de cada partida:
+//   [0..2]  posição da nave, dividida pela distância da órbita
+//   [3..5]  direção da nave
+//   [6]     vida / MAX_LIFE
+// seguida, para cada entidade próxima (inimigos, depois asteroides, depois
+// checkpoints), de 4 floats: posição relativa à nave nos eixos locais
+// (direita, cima, frente), dividida pela distância da órbita, e 1 se a
+// entidade existe (0 se há menos entidades que o número pedido).
+#define BATCHSIM_SHIP_OBS_SIZE 7
+#define BATCHSIM_OBS_SIZE (BATCHSIM_SHIP_OBS_SIZE + 4 * (BATCHSIM_NEAREST_ENEMIES + BATCHSIM_NEAREST_ASTEROIDS + BATCHSIM_NEAREST_CHECKPOINTS))
+
+struct BatchSim
+{
+    std::vector<GameState> states;            // Estado de cada partida
+
+    std::vector<unsigned char> actions;       // Entrada: bits BATCHSIM_* de cada partida
+    std::vector<float>         observations;  // Saída: BATCHSIM_OBS_SIZE floats por partida
+    std::vector<float>         rewards;       // Saída: recompensa do último passo
+    std::vector<unsigned char> dones;         // Saída: 1 se a partida terminou no último passo
+    std::vector<int>           episode_steps; // Passos desde o início da partida atual
+
+    float  delta_t;           // Duração de um passo (padrão: 1/60 s)
+    int    max_episode_steps; // Partidas mais longas são encerradas (padrão: 2 minutos)
+    int    num_threads;
+    unsigned int seed;        // Semente do lote, usada também ao reiniciar partidas
+
+    JobSystem jobs;
+};
+
+// Cria "num_envs" partidas, com sementes derivadas de "seed". Se num_threads
+// for 0, usa o número de núcleos do processador.
+void BatchSim_Init(BatchSim& batch, size_t num_envs, unsigned int seed, int num_threads = 0);
+
+// Avança todas as partidas um passo, com as ações em batch.actions, e
+// preenche observations, rewards e dones. Uma partida que termina é
+// reiniciada no mesmo passo: dones[i] == 1 e observations contém o primeiro
+// estado da nova partida.
+void BatchSim_Step(BatchSim& batch);
+
+size_t BatchSim_Count(const BatchSim& batch);
+
+#endif // _BATCHSIM_H
@@ -0,0 +1,154 @@
+#ifndef _BVH_H
+#define _BVH_H
+
+#include <cstddef>
+#include <vector>
+
+#include <glm/vec4.hpp>
+
+// Hierarquia de volumes delimitadores (BVH) de caixas alinhadas aos eixos,
+// para conjuntos de objetos que não se movem (ex.: o campo de asteroides). A
+// árvore é construída uma vez, dividindo os itens pela mediana do maior eixo,
+// e cada consulta desce somente pelos nós cuja caixa toca a forma consultada,
+// em tempo logarítmico no número de itens.
+//
+// Remover um item não reconstrói a árvore: o item fica marcado como removido
+// na sua folha ("tombstone"), e cada nó conta os itens vivos abaixo dele, para
+// que subárvores sem itens vivos sejam ignoradas.
+
+#define BVH_LEAF_SIZE 4
+#define BVH_MAX_DEPTH 64
+
+struct BvhBox {
+    float min[3];
+    float max[3];
+};
+
+struct BvhNode {
+    BvhBox box;
+    int left;            // Primeiro filho (o segundo é left + 1), -1 nas folhas
+    int parent;          // -1 na raiz
+    unsigned int first;  // Folhas: itens [first, first + count) de Bvh::items
+    unsigned int count;
+    unsigned int alive;  // Itens não removidos na subárvore
+};
+
+struct Bvh {
+    std::vector<BvhNode> nodes;            // nodes[0] é a raiz
+    std::vector<unsigned int> items;       // Itens na ordem das folhas
+    std::vector<BvhBox> itemBoxes;         // Caixa de cada item, na mesma ordem
+    std::vector<unsigned char> itemAlive;  // Idem, 0 se o item foi removido
+    std::vector<int> itemSlot;             // Posição de cada item em items
+    std::vector<int> itemLeaf;             // Folha de cada item
+};
+
+// Constrói a árvore com os itens 0 .. n-1, de caixas boxes[0 .. n-1]
+void Bvh_Build(Bvh& bvh, const BvhBox* boxes, size_t n);
+
+// Renumera os itens na ordem das folhas: depois dela, o item k é o k-ésimo
+// visitado folha a folha, e os dados de cada item podem ser guardados nessa
+// ordem (itens de uma folha ficam contíguos). "order" recebe o número antigo
+// de cada item.
+void Bvh_RenumberItems(Bvh& bvh, std::vector<unsigned int>& order);
+
+// Marca o item como removido. Devolve false se ele já tinha sido removido.
+bool Bvh_Remove(Bvh& bvh, unsigned int item);
+
+// Número de itens da última construção, incluindo os removidos
+size_t Bvh_ItemCount(const Bvh& bvh);
+
+// Número de itens não removidos
+size_t Bvh_AliveCount(const Bvh& bvh);
+
+inline bool Bvh_BoxOverlapsSphere(const BvhBox& box, const glm::vec4& c, float radius) {
+    float p[3] = { c.x, c.y, c.z };
+    float dist_sq = 0.0f;
+    for (int a = 0; a < 3; ++a) {
+        float d = 0.0f;
+        if (p[a] < box.min[a]) d = box.min[a] - p[a];
+        else if (p[a] > box.max[a]) d = p[a] - box.max[a];
+        dist_sq += d * d;
+    }
+    return dist_sq <= radius * radius;
+}
+
+inline bool Bvh_BoxesOverlap(const BvhBox& a, const BvhBox& b) {
+    return a.min[0] <= b.max[0] && b.min[0] <= a.max[0]
+        && a.min[1] <= b.max[1] && b.min[1] <= a.max[1]
+        && a.min[2] <= b.max[2] && b.min[2] <= a.max[2];
+}
+
+// Testa o segmento p0 + t * (p1 - p0), t em [0, 1], contra a caixa aumentada
+// de "radius" em todas as direções (teste das "placas" de cada eixo)
+inline bool Bvh_BoxOverlapsSegment(const BvhBox& box, const float p0[3], const float d[3], float radius) {
+    float t_min = 0.0f, t_max = 1.0f;
+    for (int a = 0; a < 3; ++a) {
+        float lo = box.min[a] - radius;
+        float hi = box.max[a] + radius;
+        if (d[a] == 0.0f) {
+            if (p0[a] < lo || p0[a] > hi)
+                return false;
+            continue;
+        }
+        float inv = 1.0f / d[a];
+        float t0 = (lo - p0[a]) * inv;
+        float t1 = (hi - p0[a]) * inv;
+        if (t0 > t1) { float t = t0; t0 = t1; t1 = t; }
+        if (t0 > t_min) t_min = t0;
+        if (t1 < t_max) t_max = t1;
+        if (t_min > t_max)
+            return false;
+    }
+    return true;
+}
+
+// Percorre a árvore visitando os nós para os quais overlaps(box) é verdadeiro,
+// e chama visit(item) para os itens vivos cuja caixa também passa no teste
+template <typename Overlaps, typename Visit>
+inline void Bvh_Traverse(const Bvh& bvh, const Overlaps& overlaps, const Visit& visit) {
+    if (bvh.nodes.empty())
+        return;
+
+    int stack[BVH_MAX_DEPTH];
+    int top = 0;
+    stack[top++] = 0;
+
+    while (top > 0) {
+        const BvhNode& node = bvh.nodes[stack[--top]];
+        if (node.alive == 0 || !overlaps(node.box))
+            continue;
+
+        if (node.left < 0) {
+            for (unsigned int k = node.first; k < node.first + node.count; ++k)
+                if (bvh.itemAlive[k] && overlaps(bvh.itemBoxes[k]))
+                    visit(bvh.items[k]);
+        } else {
+            stack[top++] = node.left + 1;
+            stack[top++] = node.left;
+        }
+    }
+}
+
+// Chama visit(item) para cada item vivo cuja caixa toca a esfera (c, radius).
+// Quem chama faz o teste exato com a forma do item.
+template <typename Visit>
+inline void Bvh_QuerySphere(const Bvh& bvh, const glm::vec4& c, float radius, const Visit& visit) {
+    Bvh_Traverse(bvh, [&](const BvhBox& box) { return Bvh_BoxOverlapsSphere(box, c, radius); }, visit);
+}
+
+// Chama visit(item) para cada item vivo cuja caixa toca a caixa "box"
+template <typename Visit>
+inline void Bvh_QueryBox(const Bvh& bvh, const BvhBox& box, const Visit& visit) {
+    Bvh_Traverse(bvh, [&](const BvhBox& other) { return Bvh_BoxesOverlap(box, other); }, visit);
+}
+
+// Chama visit(item) para cada item vivo cuja caixa toca o segmento p0-p1
+// percorrido por uma esfera de raio "radius" (0 para um segmento de raio)
+template <typename Visit>
+inline void Bvh_QuerySegment(const Bvh& bvh, const glm::vec4& p0, const glm::vec4& p1, float radius, const Visit& visit) {
+    float origin[3] = { p0.x, p0.y, p0.z };
+    float d[3] = { p1.x - p0.x, p1.y - p0.y, p1.z - p0.z };
+    Bvh_Traverse(bvh, [&](const BvhBox& box) { return Bvh_BoxOverlapsSegment(box, origin, d, radius); }, visit);
+}
+
+#endif // _BVH_H
@@ -3,7 +3,9 @@
 
 #include <glm/vec4.hpp>
 #include <glm/vec4.hpp>
+#include <glm/mat4x4.hpp>
 #include <cmath> 
+#include <cstddef>
 
 //Fonte: Gemini
 
@@ -32,6 +34,36 @@ struct BoundingCylinder {
     float height;     
 };
 
+/**
+ * Representa uma Cápsula Delimitadora: os pontos a até "radius" do segmento
+ * a-b.
+ */
+struct BoundingCapsule {
+    glm::vec4 a;
+    glm::vec4 b;
+    float radius;
+};
+
+/**
+ * Representa uma Caixa Orientada (OBB): centro, três eixos unitários e
+ * perpendiculares, e a metade da medida da caixa ao longo de cada eixo.
+ */
+struct BoundingOBB {
+    glm::vec4 center;
+    glm::vec4 axis[3];
+    float halfSize[3];
+};
+
+/**
+ * Volumes ajustados aos vértices de uma malha, nas mesmas coordenadas dos
+ * vértices (veja computeMeshBounds()).
+ */
+struct MeshBounds {
+    BoundingSphere sphere;
+    BoundingCapsule capsule;  // Ao longo do eixo mais comprido da caixa
+    BoundingOBB box;
+};
+
 
 /**
  * Calcula a distância euclidiana ao quadrado (evita raiz quadrada).
@@ -56,6 +88,126 @@ bool checkRaySphereCollision(const Ray& ray, const BoundingSphere& sphere, float
  */
 bool checkCylinderSphereCollision(const BoundingCylinder& cylinder, const BoundingSphere& sphere); // << NOVO
 
+/**
+ * OCLUSÃO ESFERA-ESFERA (Entidade escondida atrás da Lua, vista da câmera)
+ * Retorna true somente se a esfera "sphere" estiver inteiramente escondida
+ * pela esfera "occluder" quando vista a partir do ponto "eye".
+ */
+bool checkSphereOccludedBySphere(const glm::vec4& eye, const BoundingSphere& occluder, const BoundingSphere& sphere);
+
+/**
+ * CÁPSULA-ESFERA (Míssil vs. Nave/Inimigo, com volumes ajustados à malha)
+ */
+bool checkCapsuleSphereCollision(const BoundingCapsule& capsule, const BoundingSphere& sphere);
+
+/**
+ * CAIXA ORIENTADA-ESFERA (Asteroide vs. Nave/Míssil, com volumes ajustados à
+ * malha)
+ */
+bool checkOBBSphereCollision(const BoundingOBB& box, const BoundingSphere& sphere);
+
+/**
+ * RAIO-CAIXA ORIENTADA (consultas de raio contra asteroides). A direção do
+ * raio deve ser unitária; t_out recebe a distância até a entrada na caixa, ou
+ * 0 se a origem do raio está dentro dela.
+ */
+bool checkRayOBBCollision(const Ray& ray, const BoundingOBB& box, float& t_out);
+
+/**
+ * TRIÂNGULO-ESFERA (Míssil vs. Nave, com os triângulos da malha): o ponto do
+ * triângulo a-b-c mais próximo do centro da esfera precisa estar dentro dela.
+ */
+bool checkTriangleSphereCollision(const glm::vec4& a, const glm::vec4& b, const glm::vec4& c,
+                                  const BoundingSphere& sphere);
+
+/**
+ * RAIO-TRIÂNGULO (Möller-Trumbore). O ponto atingido é origin + t_out *
+ * direction, com t_out >= 0 medido em comprimentos de ray.direction (que não
+ * precisa ser unitária): com direction = p1 - p0, o segmento p0-p1 atinge o
+ * triângulo se t_out <= 1.
+ */
+bool checkRayTriangleCollision(const Ray& ray, const glm::vec4& a, const glm::vec4& b, const glm::vec4& c,
+                               float& t_out);
+
+// --- Testes Contínuos (entidades em movimento durante o passo) ---
+//
+// Cada entidade se move em linha reta durante o passo, da posição anterior à
+// atual. O teste devolve o instante t_out do primeiro contato, de 0 (início
+// do passo) a 1 (fim), e não deixa escapar colisões que acontecem no meio do
+// passo, mesmo que as entidades já tenham se separado no fim dele.
+
+/**
+ * ESFERA-ESFERA CONTÍNUA: a esfera "a" vai de a.center até a_end enquanto "b"
+ * vai de b.center até b_end.
+ */
+bool checkSweptSphereSphereCollision(const BoundingSphere& a, const glm::vec4& a_end,
+                                     const BoundingSphere& b, const glm::vec4& b_end, float& t_out);
+
+/**
+ * CILINDRO-ESFERA CONTÍNUA: a esfera vai de sphere.center até sphere_end, e o
+ * cilindro está parado. Em cada instante, o teste é o mesmo de
+ * checkCylinderSphereCollision().
+ */
+bool checkSweptCylinderSphereCollision(const BoundingCylinder& cylinder, const BoundingSphere& sphere,
+                                       const glm::vec4& sphere_end, float& t_out);
+
+
+// --- Testes em Lote (uma forma contra muitas candidatas) ---
+//
+// As candidatas são passadas como "structure of arrays": vetores de centros
+// x, y, z (e de raios/alturas, ou um valor comum a todas). Os testes são feitos
+// com SSE2, 4 candidatas por vez, ou com AVX, 8 por vez, quando compilados com
+// AVX (como em bench_collisions_avx), e com o laço escalar equivalente nas
+// restantes e em processadores sem SSE2. O programa bench_collisions confere
+// os resultados com os testes de um par por vez.
+//
+// O resultado é uma máscara de bits, um bit por candidata (bit i % 32 da
+// palavra i / 32), com COLLISION_MASK_WORDS(n) palavras. A máscara pode ser
+// NULL quando só o número de colisões interessa.
+
+#define COLLISION_MASK_WORDS(n) (((n) + 31) / 32)
+
+/**
+ * ESFERA-ESFERA em lote: "sphere" contra n esferas de centros (x, y, z) e
+ * raios "radius". Devolve o número de colisões.
+ */
+size_t checkSphereSphereBatch(const BoundingSphere& sphere, const float* x, const float* y, const float* z,
+                              const float* radius, size_t n, unsigned int* hits);
+size_t checkSphereSphereBatch(const BoundingSphere& sphere, const float* x, const float* y, const float* z,
+                              float radius, size_t n, unsigned int* hits);
+
+/**
+ * RAIO-ESFERA em lote, com o mesmo teste de checkRaySphereCollision() (a
+ * direção do raio deve ser unitária). Se t_out não for NULL, t_out[i] recebe
+ * a distância até a esfera i, ou FLT_MAX se ela não foi atingida.
+ */
+size_t checkRaySphereBatch(const Ray& ray, const float* x, const float* y, const float* z,
+                           const float* radius, size_t n, unsigned int* hits, float* t_out);
+size_t checkRaySphereBatch(const Ray& ray, const float* x, const float* y, const float* z,
+                           float radius, size_t n, unsigned int* hits, float* t_out);
+
+/**
+ * CILINDRO-ESFERA em lote: "sphere" contra n cilindros de eixo Y, de centros
+ * (x, y, z), raios "radius" e alturas "height".
+ */
+size_t checkCylinderSphereBatch(const BoundingSphere& sphere, const float* x, const float* y, const float* z,
+                                const float* radius, const float* height, size_t n, unsigned int* hits);
+size_t checkCylinderSphereBatch(const BoundingSphere& sphere, const float* x, const float* y, const float* z,
+                                float radius, float height, size_t n, unsigned int* hits);
+
+/**
+ * Caminho usado pelos testes em lote nesta compilação: "AVX", "SSE2" ou
+ * "escalar".
+ */
+const char* collisionBatchPath();
+
+/**
+ * Converte a máscara de n candidatas na lista dos índices atingidos, em ordem
+ * crescente. "list" precisa de espaço para n índices. Devolve o tamanho da
+ * lista.
+ */
+size_t collisionHitList(const unsigned int* hits, size_t n, unsigned int* list);
+
 
 float distanceSq(const glm::vec4& p1, const glm::vec4& p2);
 
@@ -64,11 +216,29 @@ extern const float AIRCRAFT_SPHERE_RADIUS;
 extern const float CHECKPOINT_RADIUS;
 extern const float ASTEROID_CYLINDER_RADIUS;
 extern const float ASTEROID_CYLINDER_HEIGHT;
+extern const float MOON_OCCLUDER_RADIUS;
+
+
+/**
+ * Ajusta os volumes aos "count" vértices (x, y, z consecutivos, como em
+ * tinyobj::attrib_t::vertices). A caixa segue os eixos principais dos
+ * vértices (ou os eixos das coordenadas, se a caixa alinhada a eles for
+ * menor), a cápsula segue o eixo mais comprido da caixa, e a esfera é a menor
+ * entre a de Ritter e a centrada na caixa.
+ */
+MeshBounds computeMeshBounds(const float* vertices, size_t count);
+
+/**
+ * Leva os volumes para outro referencial. "transform" deve combinar somente
+ * rotações, uma escala uniforme e translações (como as matrizes de modelo).
+ */
+MeshBounds transformMeshBounds(const MeshBounds& bounds, const glm::mat4& transform);
 
 
 BoundingSphere getEnemyBoundingSphere(const glm::vec4& enemyPosition);
 BoundingSphere getAircraftBoundingSphere(const glm::vec4& aircraftPosition);
 BoundingSphere getCheckpointBoundingSphere(const glm::vec4& pos);
 BoundingCylinder getAsteroidBoundingCylinder(const glm::vec4& pos); 
+BoundingSphere getMoonOccluderSphere(const glm::vec4& moonPosition);
 
 #endif // COLLISIONS_H
\ No newline at end of file
@@ -0,0 +1,83 @@
+#ifndef _JOBSYSTEM_H
+#define _JOBSYSTEM_H
+
+#include <cstddef>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include <condition_variable>
+
+// Sistema de tarefas ("jobs") com roubo de trabalho. Cada thread do conjunto
+// tem sua própria fila: ela executa primeiro as tarefas que criou (do fim da
+// fila, as mais recentes), e quando a fila esvazia rouba tarefas do início da
+// fila de outra thread. Assim as tarefas se redistribuem sozinhas quando umas
+// demoram mais que outras, sem um único lock disputado por todas as threads.
+//
+// Cada tarefa pode incrementar um JobCounter, e JobSystem_Wait() espera ele
+// chegar a zero. A thread que espera não fica parada: ela executa tarefas
+// pendentes enquanto isso, então esperar dentro de uma tarefa não trava o
+// conjunto, e com uma única thread tudo é executado dentro de Wait().
+
+struct JobCounter {
+    std::atomic<int> pending;
+    JobCounter() : pending(0) {}
+};
+
+struct Job {
+    std::function<void()> function;
+    JobCounter* counter;
+};
+
+struct JobQueue {
+    std::mutex mutex;
+    std::deque<Job> jobs;
+};
+
+struct JobSystem {
+    std::vector<std::thread> threads;
+    std::vector<JobQueue*> queues;  // Fila 0: threads de fora do conjunto
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+    std::atomic<int> queued;        // Tarefas nas filas, ainda não iniciadas
+    std::atomic<bool> quit;
+    bool started;                   // Threads auxiliares já criadas
+
+    JobSystem() : queued(0), quit(false), started(false) {}
+    ~JobSystem();
+};
+
+// Prepara num_threads - 1 threads auxiliares (a thread que chama Wait() é a
+// restante). Se num_threads for 0, usa o número de núcleos do processador.
+// As threads só são criadas quando a primeira tarefa é agendada, então um
+// sistema que nunca recebe tarefas (ex.: partidas pequenas, que a simulação
+// avança sem paralelismo) não mantém threads paradas.
+void JobSystem_Init(JobSystem& jobs, int num_threads = 0);
+
+// Termina as threads auxiliares. Chamado também pelo destrutor.
+void JobSystem_Shutdown(JobSystem& jobs);
+
+// Número de threads que executam tarefas, incluindo a que espera
+int JobSystem_ThreadCount(const JobSystem& jobs);
+
+// Agenda "function". Se counter não for nulo, ele é incrementado agora e
+// decrementado quando a tarefa termina.
+void JobSystem_Run(JobSystem& jobs, const std::function<void()>& function, JobCounter* counter);
+
+// Agenda "function" para depois que "dependency" chegar a zero (dependência
+// entre tarefas). A tarefa ocupa uma thread, que ajuda a executar as tarefas
+// pendentes enquanto espera.
+void JobSystem_RunAfter(JobSystem& jobs, JobCounter& dependency, const std::function<void()>& function, JobCounter* counter);
+
+// Espera "counter" chegar a zero, executando tarefas enquanto isso
+void JobSystem_Wait(JobSystem& jobs, JobCounter& counter);
+
+// Divide [0, n) em blocos de até "grain" elementos, executa body(begin, end)
+// para cada bloco em paralelo e espera todos terminarem. Os blocos são sempre
+// os mesmos para o mesmo n e grain, independentemente do número de threads.
+void JobSystem_ParallelFor(JobSystem& jobs, size_t n, size_t grain,
+                           const std::function<void(size_t, size_t)>& body);
+
+#endif // _JOBSYSTEM_H
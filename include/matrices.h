@@ -27,7 +27,7 @@
 //
 // Para conseguirmos definir matrizes através de suas LINHAS, a função Matrix()
 // computa a transposta usando os elementos passados por parâmetros.
-glm::mat4 Matrix(
+inline glm::mat4 Matrix(
     float m00, float m01, float m02, float m03, // LINHA 1
     float m10, float m11, float m12, float m13, // LINHA 2
     float m20, float m21, float m22, float m23, // LINHA 3
@@ -43,7 +43,7 @@ glm::mat4 Matrix(
 }
 
 // Matriz identidade.
-glm::mat4 Matrix_Identity()
+inline glm::mat4 Matrix_Identity()
 {
     return Matrix(
         1.0f , 0.0f , 0.0f , 0.0f , // LINHA 1
@@ -59,7 +59,7 @@ glm::mat4 Matrix_Identity()
 //
 //     T*p = p+t.
 //
-glm::mat4 Matrix_Translate(float tx, float ty, float tz)
+inline glm::mat4 Matrix_Translate(float tx, float ty, float tz)
 {
     return Matrix(
         1.0f , 0.0f , 0.0f , tx ,
@@ -75,7 +75,7 @@ glm::mat4 Matrix_Translate(float tx, float ty, float tz)
 //
 //     S*p = [sx*px, sy*py, sz*pz, pw].
 //
-glm::mat4 Matrix_Scale(float sx, float sy, float sz)
+inline glm::mat4 Matrix_Scale(float sx, float sy, float sz)
 {
     return Matrix(
         sx   , 0.0f , 0.0f , 0.0f ,
@@ -93,7 +93,7 @@ glm::mat4 Matrix_Scale(float sx, float sy, float sz)
 //   R*p = [ px, c*py-s*pz, s*py+c*pz, pw ];
 //
 // onde 'c' e 's' são o cosseno e o seno do ângulo de rotação, respectivamente.
-glm::mat4 Matrix_Rotate_X(float angle)
+inline glm::mat4 Matrix_Rotate_X(float angle)
 {
     float c = cos(angle);
     float s = sin(angle);
@@ -113,7 +113,7 @@ glm::mat4 Matrix_Rotate_X(float angle)
 //   R*p = [ c*px+s*pz, py, -s*px+c*pz, pw ];
 //
 // onde 'c' e 's' são o cosseno e o seno do ângulo de rotação, respectivamente.
-glm::mat4 Matrix_Rotate_Y(float angle)
+inline glm::mat4 Matrix_Rotate_Y(float angle)
 {
     float c = cos(angle);
     float s = sin(angle);
@@ -133,7 +133,7 @@ glm::mat4 Matrix_Rotate_Y(float angle)
 //   R*p = [ c*px-s*py, s*px+c*py, pz, pw ];
 //
 // onde 'c' e 's' são o cosseno e o seno do ângulo de rotação, respectivamente.
-glm::mat4 Matrix_Rotate_Z(float angle)
+inline glm::mat4 Matrix_Rotate_Z(float angle)
 {
     float c = cos(angle);
     float s = sin(angle);
@@ -147,7 +147,7 @@ glm::mat4 Matrix_Rotate_Z(float angle)
 
 // Função que calcula a norma Euclidiana de um vetor cujos coeficientes são
 // definidos em uma base ortonormal qualquer.
-float norm(glm::vec4 v)
+inline float norm(glm::vec4 v)
 {
     float vx = v.x;
     float vy = v.y;
@@ -160,7 +160,7 @@ float norm(glm::vec4 v)
 // coordenadas e em torno do eixo definido pelo vetor 'axis'. Esta matriz pode
 // ser definida pela fórmula de Rodrigues. Lembre-se que o vetor que define o
 // eixo de rotação deve ser normalizado!
-glm::mat4 Matrix_Rotate(float angle, glm::vec4 axis)
+inline glm::mat4 Matrix_Rotate(float angle, glm::vec4 axis)
 {
     float c = cos(angle);
     float s = sin(angle);
@@ -181,7 +181,7 @@ glm::mat4 Matrix_Rotate(float angle, glm::vec4 axis)
 
 // Produto vetorial entre dois vetores u e v definidos em um sistema de
 // coordenadas ortonormal.
-glm::vec4 crossproduct(glm::vec4 u, glm::vec4 v)
+inline glm::vec4 crossproduct(glm::vec4 u, glm::vec4 v)
 {
     float u1 = u.x;
     float u2 = u.y;
@@ -200,7 +200,7 @@ glm::vec4 crossproduct(glm::vec4 u, glm::vec4 v)
 
 // Produto escalar entre dois vetores u e v definidos em um sistema de
 // coordenadas ortonormal.
-float dotproduct(glm::vec4 u, glm::vec4 v)
+inline float dotproduct(glm::vec4 u, glm::vec4 v)
 {
     float u1 = u.x;
     float u2 = u.y;
@@ -221,7 +221,7 @@ float dotproduct(glm::vec4 u, glm::vec4 v)
 }
 
 // Matriz de mudança de coordenadas para o sistema de coordenadas da Câmera.
-glm::mat4 Matrix_Camera_View(glm::vec4 position_c, glm::vec4 view_vector, glm::vec4 up_vector)
+inline glm::mat4 Matrix_Camera_View(glm::vec4 position_c, glm::vec4 view_vector, glm::vec4 up_vector)
 {
     glm::vec4 w = -view_vector;
     glm::vec4 u = crossproduct(up_vector, w);
@@ -253,7 +253,7 @@ glm::mat4 Matrix_Camera_View(glm::vec4 position_c, glm::vec4 view_vector, glm::v
 }
 
 // Matriz de projeção paralela ortográfica
-glm::mat4 Matrix_Orthographic(float l, float r, float b, float t, float n, float f)
+inline glm::mat4 Matrix_Orthographic(float l, float r, float b, float t, float n, float f)
 {
     glm::mat4 M = Matrix(
         2.0f/(r-l) , 0.0f       , 0.0f       , -(r+l)/(r-l) ,
@@ -266,7 +266,7 @@ glm::mat4 Matrix_Orthographic(float l, float r, float b, float t, float n, float
 }
 
 // Matriz de projeção perspectiva
-glm::mat4 Matrix_Perspective(float field_of_view, float aspect, float n, float f)
+inline glm::mat4 Matrix_Perspective(float field_of_view, float aspect, float n, float f)
 {
     float t = fabs(n) * tanf(field_of_view / 2.0f);
     float b = -t;
@@ -321,7 +321,7 @@ glm::mat4 Matrix_Perspective(float field_of_view, float aspect, float n, float f
 }
 
 // Função que imprime uma matriz M no terminal
-void PrintMatrix(glm::mat4 M)
+inline void PrintMatrix(glm::mat4 M)
 {
     printf("\n");
     printf("[ %+0.2f  %+0.2f  %+0.2f  %+0.2f ]\n", M[0][0], M[1][0], M[2][0], M[3][0]);
@@ -331,7 +331,7 @@ void PrintMatrix(glm::mat4 M)
 }
 
 // Função que imprime um vetor v no terminal
-void PrintVector(glm::vec4 v)
+inline void PrintVector(glm::vec4 v)
 {
     printf("\n");
     printf("[ %+0.2f ]\n", v[0]);
@@ -341,7 +341,7 @@ void PrintVector(glm::vec4 v)
 }
 
 // Função que imprime o produto de uma matriz por um vetor no terminal
-void PrintMatrixVectorProduct(glm::mat4 M, glm::vec4 v)
+inline void PrintMatrixVectorProduct(glm::mat4 M, glm::vec4 v)
 {
     auto r = M*v;
     printf("\n");
@@ -353,7 +353,7 @@ void PrintMatrixVectorProduct(glm::mat4 M, glm::vec4 v)
 
 // Função que imprime o produto de uma matriz por um vetor, junto com divisão
 // por w, no terminal.
-void PrintMatrixVectorProductDivW(glm::mat4 M, glm::vec4 v)
+inline void PrintMatrixVectorProductDivW(glm::mat4 M, glm::vec4 v)
 {
     auto r = M*v;
     auto w = r[3];
@@ -0,0 +1,58 @@
+#ifndef _MESHCOLLIDER_H
+#define _MESHCOLLIDER_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <glm/vec4.hpp>
+#include <glm/mat4x4.hpp>
+
+#include "bvh.h"
+
+// Triângulos de uma malha para testes de colisão precisos (ex.: a nave de
+// "aircraft.obj", com asas, fuselagem e as outras peças separadas). Cada parte
+// da malha (um grupo do .obj) tem uma BVH dos seus triângulos ("bvh.h"),
+// montada uma vez ao carregar a malha, e uma BVH das caixas das partes escolhe
+// as partes a consultar. Os triângulos ficam guardados na ordem das folhas,
+// então cada folha lê vértices contíguos.
+//
+// Os triângulos ficam no referencial da entidade, e cada consulta recebe o
+// referencial atual dela ("frame": rotação e translação, colunas unitárias e
+// perpendiculares, como Sim_OrbitFrame()): a esfera ou o segmento consultado
+// é levado para o referencial da malha, e a malha nunca é transformada. As
+// consultas são o último teste, feito só depois que os volumes simples
+// (esfera envolvente, cápsula) já acusaram contato.
+
+struct MeshColliderPart {
+    std::string name;
+    Bvh bvh;                        // Item k: triângulo k de "triangles"
+    std::vector<float> triangles;   // 9 floats por triângulo (x, y, z dos três vértices)
+};
+
+struct MeshCollider {
+    std::vector<MeshColliderPart> parts;
+    Bvh partBvh;                    // Item p: caixa de todos os triângulos da parte p
+};
+
+// Acrescenta uma parte com os triângulos indices[3k .. 3k+2], k = 0 .. n-1,
+// que indicam vértices de "vertices" (x, y, z). Os vértices são levados ao
+// referencial da entidade por "transform" (a mesma transformação usada ao
+// desenhar a malha). Triângulos sem área são ignorados.
+void MeshCollider_AddPart(MeshCollider& mesh, const char* name, const float* vertices,
+                          const unsigned int* indices, size_t n, const glm::mat4& transform);
+
+size_t MeshCollider_TriangleCount(const MeshCollider& mesh);
+
+// Testa se a esfera (center, radius) toca algum triângulo da malha colocada
+// no referencial "frame"
+bool MeshCollider_OverlapSphere(const MeshCollider& mesh, const glm::mat4& frame,
+                                const glm::vec4& center, float radius);
+
+// Primeiro triângulo da malha no referencial "frame" atingido pelo segmento
+// p0 + t * (p1 - p0), t em [0, 1]. Devolve false se nenhum é atingido; senão
+// t_out recebe t e, se part_out não for NULL, part_out recebe a parte atingida.
+bool MeshCollider_Segment(const MeshCollider& mesh, const glm::mat4& frame,
+                          const glm::vec4& p0, const glm::vec4& p1, float& t_out, int* part_out = NULL);
+
+#endif // _MESHCOLLIDER_H
@@ -0,0 +1,187 @@
+#ifndef _MISSILEPOOL_H
+#define _MISSILEPOOL_H
+
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+
+#include <glm/vec4.hpp>
+
+// Conjunto de mísseis com capacidade fixa, alocado uma única vez em reserve().
+// Disparar (spawn) e remover (remove/despawn) são O(1) e não alocam memória,
+// mesmo com milhares de mísseis ao mesmo tempo.
+//
+// Os mísseis vivos ficam compactados no início de cada vetor (índices densos
+// 0..size()-1, em "structure of arrays"), e os laços de movimento e colisão
+// percorrem somente esses índices. Como a remoção move o último míssil para a
+// posição removida, o índice denso de um míssil pode mudar; para guardar uma
+// referência estável use o MissileHandle devolvido por spawn(), que indica uma
+// vaga ("slot") e a geração dela. Cada vez que a vaga é liberada sua geração é
+// incrementada, e handles antigos deixam de ser válidos.
+
+// Capacidade padrão de cada partida. O jogo normal tem poucos mísseis vivos
+// ao mesmo tempo; modos com muitos tiros podem chamar reserve() com uma
+// capacidade maior antes de Sim_Reset().
+#define MISSILE_POOL_CAPACITY 64
+
+struct MissileHandle {
+    unsigned int slot;
+    unsigned int generation; // 0: handle inválido
+};
+
+struct MissilePool {
+    // Campos dos mísseis vivos, por índice denso
+    std::vector<float> x, y, z;
+    std::vector<float> fx, fy, fz;
+    std::vector<float> prev_x, prev_y, prev_z;    // Posição e direção no passo de
+    std::vector<float> prev_fx, prev_fy, prev_fz; // simulação anterior
+    std::vector<unsigned char> ownerId;  // Quem disparou (0: Nave, 1: Inimigo)
+    std::vector<unsigned int> slot;      // Vaga de cada míssil vivo
+
+    // Dados de cada vaga
+    std::vector<unsigned int> denseIndex; // Índice denso do míssil na vaga
+    std::vector<unsigned int> generation;
+    std::vector<unsigned int> freeSlots;  // Pilha de vagas livres
+    size_t freeCount;
+
+    size_t count;
+
+    MissilePool() : freeCount(0), count(0) {}
+
+    size_t size() const { return count; }
+    size_t capacity() const { return x.size(); }
+
+    // Aloca espaço para "capacity" mísseis. Remove todos os mísseis vivos.
+    void reserve(size_t capacity) {
+        std::vector<float>* fields[] = { &x, &y, &z, &fx, &fy, &fz,
+                                         &prev_x, &prev_y, &prev_z, &prev_fx, &prev_fy, &prev_fz };
+        for (size_t f = 0; f < sizeof(fields) / sizeof(fields[0]); ++f)
+            fields[f]->assign(capacity, 0.0f);
+        ownerId.assign(capacity, 0);
+        slot.assign(capacity, 0);
+        denseIndex.assign(capacity, 0);
+        generation.assign(capacity, 1);
+        freeSlots.resize(capacity);
+        count = 0;
+        clear();
+    }
+
+    // Remove todos os mísseis, sem liberar memória
+    void clear() {
+        for (size_t i = 0; i < count; ++i)
+            ++generation[slot[i]];
+        count = 0;
+
+        // A vaga 0 é a primeira a ser usada
+        freeCount = freeSlots.size();
+        for (size_t s = 0; s < freeCount; ++s)
+            freeSlots[s] = (unsigned int)(freeCount - 1 - s);
+    }
+
+    // Adiciona um míssil. Com o conjunto cheio o disparo é ignorado e o
+    // handle devolvido é inválido.
+    MissileHandle spawn(const glm::vec4& position, const glm::vec4& forward, unsigned char owner) {
+        MissileHandle handle = { 0, 0 };
+        if (freeCount == 0)
+            return handle;
+
+        unsigned int s = freeSlots[--freeCount];
+        size_t i = count++;
+
+        x[i] = prev_x[i] = position.x; y[i] = prev_y[i] = position.y; z[i] = prev_z[i] = position.z;
+        fx[i] = prev_fx[i] = forward.x; fy[i] = prev_fy[i] = forward.y; fz[i] = prev_fz[i] = forward.z;
+        ownerId[i] = owner;
+        slot[i] = s;
+        denseIndex[s] = (unsigned int)i;
+
+        handle.slot = s;
+        handle.generation = generation[s];
+        return handle;
+    }
+
+    // Libera a vaga do míssil de índice denso i, invalidando os handles dela
+    void release(size_t i) {
+        ++generation[slot[i]];
+        freeSlots[freeCount++] = slot[i];
+    }
+
+    // Remove o míssil de índice denso i, movendo o último para a posição i
+    void remove(size_t i) {
+        size_t last = --count;
+        unsigned int s = slot[i];
+
+        x[i] = x[last]; y[i] = y[last]; z[i] = z[last];
+        fx[i] = fx[last]; fy[i] = fy[last]; fz[i] = fz[last];
+        prev_x[i] = prev_x[last]; prev_y[i] = prev_y[last]; prev_z[i] = prev_z[last];
+        prev_fx[i] = prev_fx[last]; prev_fy[i] = prev_fy[last]; prev_fz[i] = prev_fz[last];
+        ownerId[i] = ownerId[last];
+        slot[i] = slot[last];
+        denseIndex[slot[i]] = (unsigned int)i;
+
+        ++generation[s];
+        freeSlots[freeCount++] = s;
+    }
+
+    // Remove todos os mísseis i com dead[i] != 0 de uma vez. Como em
+    // remove(), cada posição removida recebe o último míssil que fica, e
+    // somente os mísseis do fim são movidos.
+    void compact(const std::vector<unsigned char>& dead) {
+        size_t last = count;
+        for (size_t i = 0; i < last; ++i) {
+            if (!dead[i])
+                continue;
+            release(i);
+
+            // Descarta os removidos do fim, até achar um míssil que fica
+            while (last > i + 1 && dead[last - 1])
+                release(--last);
+            if (last == i + 1) {
+                last = i;
+                break;
+            }
+
+            --last;
+            x[i] = x[last]; y[i] = y[last]; z[i] = z[last];
+            fx[i] = fx[last]; fy[i] = fy[last]; fz[i] = fz[last];
+            prev_x[i] = prev_x[last]; prev_y[i] = prev_y[last]; prev_z[i] = prev_z[last];
+            prev_fx[i] = prev_fx[last]; prev_fy[i] = prev_fy[last]; prev_fz[i] = prev_fz[last];
+            ownerId[i] = ownerId[last];
+            slot[i] = slot[last];
+            denseIndex[slot[i]] = (unsigned int)i;
+        }
+        count = last;
+    }
+
+    bool isAlive(MissileHandle handle) const {
+        return handle.generation != 0 && handle.slot < generation.size()
+            && generation[handle.slot] == handle.generation;
+    }
+
+    // Índice denso atual do míssil; o handle precisa estar vivo
+    size_t index(MissileHandle handle) const { return denseIndex[handle.slot]; }
+
+    // Remove o míssil do handle, se ele ainda existir
+    bool despawn(MissileHandle handle) {
+        if (!isAlive(handle))
+            return false;
+        remove(denseIndex[handle.slot]);
+        return true;
+    }
+
+    // Copia o estado atual para o estado anterior (início de cada passo)
+    void savePrevious() {
+        std::copy(x.begin(), x.begin() + count, prev_x.begin());
+        std::copy(y.begin(), y.begin() + count, prev_y.begin());
+        std::copy(z.begin(), z.begin() + count, prev_z.begin());
+        std::copy(fx.begin(), fx.begin() + count, prev_fx.begin());
+        std::copy(fy.begin(), fy.begin() + count, prev_fy.begin());
+        std::copy(fz.begin(), fz.begin() + count, prev_fz.begin());
+    }
+
+    glm::vec4 position(size_t i) const { return glm::vec4(x[i], y[i], z[i], 1.0f); }
+    glm::vec4 forward(size_t i) const { return glm::vec4(fx[i], fy[i], fz[i], 0.0f); }
+    glm::vec4 prevPosition(size_t i) const { return glm::vec4(prev_x[i], prev_y[i], prev_z[i], 1.0f); }
+    glm::vec4 prevForward(size_t i) const { return glm::vec4(prev_fx[i], prev_fy[i], prev_fz[i], 0.0f); }
+};
+
+#endif // _MISSILEPOOL_H
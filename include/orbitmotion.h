@@ -0,0 +1,45 @@
+#ifndef _ORBITMOTION_H
+#define _ORBITMOTION_H
+
+#include <cstddef>
+
+#include <glm/vec4.hpp>
+
+// Movimento sobre a órbita em torno da lua, em forma fechada.
+//
+// Um corpo na órbita é descrito pela direção p (do centro da órbita até o
+// corpo, unitária) e pela direção de voo f (unitária e tangente à esfera).
+// Avançar um ângulo a ao longo do grande círculo definido por (p, f) é uma
+// rotação no plano de p e f:
+//
+//     p' = p cos(a) + f sin(a)
+//     f' = f cos(a) - p sin(a)
+//
+// que dá o mesmo resultado que girar p e f em torno do eixo "right" = p x f
+// com Matrix_Rotate(), sem montar nenhuma matriz. Antes do passo, p e f são
+// normalizados e f é projetado no plano tangente, então os erros de
+// arredondamento não se acumulam entre os passos.
+
+// Avança n corpos o mesmo ângulo "angle" (em radianos). As posições (x, y, z)
+// estão em coordenadas do mundo e voltam exatamente para a esfera de centro
+// "center" e raio "radius"; (fx, fy, fz) são as direções de voo. Os vetores
+// são processados em blocos de 4 com SSE, quando disponível.
+void Orbit_Advance(float* x, float* y, float* z, float* fx, float* fy, float* fz, size_t n,
+                   const glm::vec4& center, float radius, float angle);
+
+// Mesmo que Orbit_Advance() para um único corpo guardado em glm::vec4
+void Orbit_AdvanceOne(glm::vec4& position, glm::vec4& forward,
+                      const glm::vec4& center, float radius, float angle);
+
+// Gira a direção de voo de n corpos na direção de "target", no máximo
+// "max_turn" radianos, sem sair do plano tangente (perseguição dos inimigos).
+// Se o alvo está a menos de max_turn, a nova direção aponta exatamente para
+// ele. Em vez de calcular o ângulo com acos, compara o cosseno do ângulo com
+// cos(max_turn), e a rotação é feita no plano de f e da direção do alvo.
+// Com SSE, processa 4 corpos por vez (o resto é completado até 4) e usa a
+// aproximação da raiz quadrada inversa do processador, refinada com um passo
+// de Newton-Raphson (erro relativo em torno de 1e-7).
+void Orbit_Steer(const float* x, const float* y, const float* z, float* fx, float* fy, float* fz, size_t n,
+                 const glm::vec4& target, const glm::vec4& center, float max_turn);
+
+#endif // _ORBITMOTION_H
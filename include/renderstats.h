@@ -0,0 +1,50 @@
+#ifndef _RENDERSTATS_H
+#define _RENDERSTATS_H
+
+#include <cstddef>
+
+#include <glad/glad.h>
+
+// Contadores de trabalho enviado para a GPU em um quadro. São incrementados
+// pelas funções RenderStats_*() abaixo, que substituem as chamadas OpenGL
+// correspondentes no caminho de renderização (DrawVirtualObject(), céu, HUD e
+// texto). Servem para verificar se o agrupamento (batching) e o descarte
+// (culling) estão funcionando, e para perceber regressões. Texturas não são
+// contadas: cada uma fica ligada a uma unidade fixa desde o carregamento.
+struct RenderStats
+{
+    unsigned int draw_calls;      // glDrawElements() + glDrawArrays()
+    unsigned int triangles;       // Triângulos enviados nas chamadas acima
+    unsigned int uniform_uploads; // glUniform*()
+    unsigned int program_binds;   // glUseProgram()
+    unsigned int vao_binds;       // glBindVertexArray()
+    unsigned int buffer_uploads;  // glBufferData() + glBufferSubData()
+    size_t       buffer_bytes;    // Bytes enviados nas chamadas acima
+    unsigned int culled_objects;  // Objetos descartados antes de serem desenhados
+};
+
+// Chamadas OpenGL com contagem
+void RenderStats_DrawElements(GLenum mode, GLsizei count, GLenum type, const void* indices);
+void RenderStats_DrawArrays(GLenum mode, GLint first, GLsizei count);
+void RenderStats_Uniform1i(GLint location, GLint v0);
+void RenderStats_Uniform4f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3);
+void RenderStats_UniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value);
+void RenderStats_UseProgram(GLuint program);
+void RenderStats_BindVertexArray(GLuint array);
+void RenderStats_BufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage);
+void RenderStats_BufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data);
+
+// Contagem de objetos que não foram desenhados (ex.: escondidos atrás da lua)
+void RenderStats_CountCulled();
+
+// Encerra o quadro atual: guarda os contadores (veja RenderStats_LastFrame()),
+// escreve uma linha no arquivo de log, se ativo, e zera os contadores.
+void RenderStats_EndFrame();
+const RenderStats& RenderStats_LastFrame();
+
+// Log opcional, em CSV, com os contadores de cada quadro
+bool RenderStats_StartLog(const char* filename);
+void RenderStats_StopLog();
+bool RenderStats_IsLogging();
+
+#endif // _RENDERSTATS_H
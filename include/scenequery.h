@@ -0,0 +1,81 @@
+#ifndef _SCENEQUERY_H
+#define _SCENEQUERY_H
+
+#include <cstddef>
+#include <vector>
+
+#include <glm/vec4.hpp>
+
+#include "simulation.h"
+#include "collisions.h"
+#include "spheregrid.h"
+
+// Consultas sobre as entidades de uma partida: o que um raio atinge (o
+// primeiro alvo ou todos) e o que está dentro de uma esfera, com filtro por
+// categoria de entidade. Servem para mira, linha de visada e ferramentas, sem
+// laços escritos à mão sobre cada vetor do GameState.
+//
+// Os inimigos são procurados em uma grade sobre a esfera ("spheregrid.h"),
+// montada por SceneQuery_Update(), e os asteroides na BVH do próprio estado;
+// os mísseis, com os testes em lote de "collisions.h". Cada entidade é testada
+// com o volume usado nas colisões:
+//   - nave e inimigos: a esfera envolvente (e, nas consultas de esfera, a
+//     cápsula ajustada à malha, se houver; veja Sim_SetMeshBounds()) e, com
+//     Sim_SetAircraftMesh(), os triângulos da malha;
+//   - asteroides: a caixa orientada ajustada à malha ou, sem ela, o cilindro
+//     (a caixa dele, nos raios);
+//   - checkpoints e mísseis: as esferas deles.
+
+// Categorias de entidade (bits, combinados nos filtros)
+enum SceneQueryCategory {
+    QUERY_AIRCRAFT   = 1 << 0,
+    QUERY_ENEMY      = 1 << 1,
+    QUERY_ASTEROID   = 1 << 2,
+    QUERY_CHECKPOINT = 1 << 3,
+    QUERY_MISSILE    = 1 << 4,
+    QUERY_ALL        = (1 << 5) - 1
+};
+
+struct SceneQueryHit {
+    unsigned int category;  // Um dos bits de SceneQueryCategory, 0 se nada foi atingido
+    int index;              // Índice da entidade no vetor da categoria (0 para a nave), -1 se nada
+    float distance;         // Distância ao longo do raio (0 se a origem está dentro; 0 nas esferas)
+};
+
+struct SceneQuery {
+    const GameState* state;
+    SphereGrid enemyGrid;   // Itens são índices de state->enemies
+    bool useEnemyGrid;
+
+    SceneQuery() : state(NULL), useEnemyGrid(false) {}
+};
+
+// Prepara as consultas sobre "state". Precisa ser chamada de novo depois de
+// cada Sim_Step() (ou qualquer outra mudança no estado) antes de novas
+// consultas; o estado precisa continuar existindo enquanto elas forem feitas.
+void SceneQuery_Update(SceneQuery& query, const GameState& state);
+
+// Primeiro alvo das categorias "categories" atingido pelo raio (direção
+// unitária) até "max_distance". Empates na distância ficam com a menor
+// categoria e, nela, o menor índice. Devolve false se nada foi atingido.
+bool SceneQuery_RaycastClosest(const SceneQuery& query, const Ray& ray, float max_distance,
+                               unsigned int categories, SceneQueryHit& hit);
+
+// Todos os alvos atingidos pelo raio até "max_distance", em ordem de
+// distância. Devolve o número de alvos escritos em "hits" (que é limpo antes).
+size_t SceneQuery_RaycastAll(const SceneQuery& query, const Ray& ray, float max_distance,
+                             unsigned int categories, std::vector<SceneQueryHit>& hits);
+
+// Todos os alvos que tocam a esfera, em ordem de categoria e índice
+size_t SceneQuery_OverlapSphere(const SceneQuery& query, const BoundingSphere& sphere,
+                                unsigned int categories, std::vector<SceneQueryHit>& hits);
+
+struct JobSystem;
+
+// Primeiro alvo de cada um dos n raios, em hits[0 .. n-1] (categoria 0 e
+// índice -1 nos que não atingem nada). Com "jobs", os raios são divididos
+// entre as threads do sistema de tarefas.
+void SceneQuery_RaycastBatch(const SceneQuery& query, const Ray* rays, size_t n, float max_distance,
+                             unsigned int categories, SceneQueryHit* hits, JobSystem* jobs = NULL);
+
+#endif // _SCENEQUERY_H
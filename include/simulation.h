@@ -0,0 +1,329 @@
+#ifndef _SIMULATION_H
+#define _SIMULATION_H
+
+#include <vector>
+
+#include <glm/vec4.hpp>
+#include <glm/mat4x4.hpp>
+
+#include "missilepool.h"
+#include "timerwheel.h"
+#include "spheregrid.h"
+#include "bvh.h"
+#include "collisions.h"
+
+// Simulação do jogo (nave, inimigos, checkpoints, asteroides e mísseis),
+// independente de GLFW e OpenGL. Todo o estado de uma partida fica em um
+// GameState, e as teclas do jogador são passadas em um SimInput; assim é
+// possível simular partidas sem janela nem GPU (ex.: em servidores de CI).
+
+#define MAX_LIFE 3
+
+// Remove o elemento i de um vetor em O(1), movendo o último elemento para a
+// posição i. A ordem dos elementos não é preservada.
+template <typename T>
+inline void SwapRemove(std::vector<T>& v, size_t i) {
+    v[i] = v.back();
+    v.pop_back();
+}
+
+// Remove de uma vez os elementos i com dead[i] != 0 de um vetor (ou conjunto
+// de vetores) de n elementos. Como em SwapRemove(), cada posição removida
+// recebe o último elemento que fica, então só os elementos do fim são
+// movidos. Chama removed(i) para cada removido e move(from, to) para cada
+// elemento movido, e devolve o novo tamanho.
+template <typename Removed, typename Move>
+inline size_t SwapCompact(const std::vector<unsigned char>& dead, size_t n, const Removed& removed, const Move& move) {
+    size_t last = n;
+    for (size_t i = 0; i < last; ++i) {
+        if (!dead[i])
+            continue;
+        removed(i);
+
+        // Descarta os removidos do fim, até achar um elemento que fica
+        while (last > i + 1 && dead[last - 1])
+            removed(--last);
+        if (last == i + 1)
+            return i;
+
+        move(--last, i);
+    }
+    return last;
+}
+
+// As entidades são guardadas como "structure of arrays" (SoA): um vetor
+// contíguo para cada campo, com o mesmo índice em todos os vetores. Os laços
+// de movimento e colisão leem somente os campos que usam, e os laços simples
+// (ex.: distâncias para todos os asteroides) podem ser vetorizados pelo
+// compilador. As remoções isoladas são feitas com SwapRemove() em cada campo;
+// as das colisões de um passo, todas juntas com compact() (SwapCompact()).
+
+// Inimigos: posição, direção (tangente à órbita) e estado do passo anterior.
+// Cada inimigo recebe um id fixo (a ordem de criação desde o último clear()),
+// usado pelos eventos agendados, já que o índice muda com as remoções.
+struct EnemyArray {
+    std::vector<float> x, y, z;
+    std::vector<float> fx, fy, fz;
+    std::vector<float> prev_x, prev_y, prev_z;    // Posição e direção no passo de
+    std::vector<float> prev_fx, prev_fy, prev_fz; // simulação anterior, usadas para
+                                                  // interpolar a renderização
+    std::vector<unsigned int> id;
+    std::vector<int> indexOf;                     // Índice de cada id, -1 se destruído
+
+    size_t size() const { return x.size(); }
+
+    void clear() {
+        x.clear(); y.clear(); z.clear();
+        fx.clear(); fy.clear(); fz.clear();
+        prev_x.clear(); prev_y.clear(); prev_z.clear();
+        prev_fx.clear(); prev_fy.clear(); prev_fz.clear();
+        id.clear(); indexOf.clear();
+    }
+
+    // Devolve o id do novo inimigo
+    unsigned int push_back(const glm::vec4& position, const glm::vec4& forward) {
+        x.push_back(position.x); y.push_back(position.y); z.push_back(position.z);
+        fx.push_back(forward.x); fy.push_back(forward.y); fz.push_back(forward.z);
+        prev_x.push_back(position.x); prev_y.push_back(position.y); prev_z.push_back(position.z);
+        prev_fx.push_back(forward.x); prev_fy.push_back(forward.y); prev_fz.push_back(forward.z);
+        id.push_back((unsigned int)indexOf.size());
+        indexOf.push_back((int)x.size() - 1);
+        return id.back();
+    }
+
+    void remove(size_t i) {
+        SwapRemove(x, i); SwapRemove(y, i); SwapRemove(z, i);
+        SwapRemove(fx, i); SwapRemove(fy, i); SwapRemove(fz, i);
+        SwapRemove(prev_x, i); SwapRemove(prev_y, i); SwapRemove(prev_z, i);
+        SwapRemove(prev_fx, i); SwapRemove(prev_fy, i); SwapRemove(prev_fz, i);
+        indexOf[id[i]] = -1;
+        SwapRemove(id, i);
+        if (i < id.size())
+            indexOf[id[i]] = (int)i;
+    }
+
+    // Remove todos os inimigos i com dead[i] != 0 (veja SwapCompact())
+    void compact(const std::vector<unsigned char>& dead) {
+        size_t n = SwapCompact(dead, size(),
+            [&](size_t i) { indexOf[id[i]] = -1; },
+            [&](size_t from, size_t to) {
+                x[to] = x[from]; y[to] = y[from]; z[to] = z[from];
+                fx[to] = fx[from]; fy[to] = fy[from]; fz[to] = fz[from];
+                prev_x[to] = prev_x[from]; prev_y[to] = prev_y[from]; prev_z[to] = prev_z[from];
+                prev_fx[to] = prev_fx[from]; prev_fy[to] = prev_fy[from]; prev_fz[to] = prev_fz[from];
+                id[to] = id[from];
+                indexOf[id[to]] = (int)to;
+            });
+        x.resize(n); y.resize(n); z.resize(n);
+        fx.resize(n); fy.resize(n); fz.resize(n);
+        prev_x.resize(n); prev_y.resize(n); prev_z.resize(n);
+        prev_fx.resize(n); prev_fy.resize(n); prev_fz.resize(n);
+        id.resize(n);
+    }
+
+    glm::vec4 position(size_t i) const { return glm::vec4(x[i], y[i], z[i], 1.0f); }
+    glm::vec4 forward(size_t i) const { return glm::vec4(fx[i], fy[i], fz[i], 0.0f); }
+    glm::vec4 prevPosition(size_t i) const { return glm::vec4(prev_x[i], prev_y[i], prev_z[i], 1.0f); }
+    glm::vec4 prevForward(size_t i) const { return glm::vec4(prev_fx[i], prev_fy[i], prev_fz[i], 0.0f); }
+};
+
+// Asteroides parados na órbita: somente a posição. Como nos inimigos, cada
+// asteroide tem um id fixo, usado pela BVH do campo de asteroides.
+struct AsteroidArray {
+    std::vector<float> x, y, z;
+    std::vector<unsigned int> id;
+    std::vector<int> indexOf;                     // Índice de cada id, -1 se destruído
+
+    size_t size() const { return x.size(); }
+
+    void clear() { x.clear(); y.clear(); z.clear(); id.clear(); indexOf.clear(); }
+
+    unsigned int push_back(const glm::vec4& position) {
+        x.push_back(position.x); y.push_back(position.y); z.push_back(position.z);
+        id.push_back((unsigned int)indexOf.size());
+        indexOf.push_back((int)x.size() - 1);
+        return id.back();
+    }
+
+    void remove(size_t i) {
+        SwapRemove(x, i); SwapRemove(y, i); SwapRemove(z, i);
+        indexOf[id[i]] = -1;
+        SwapRemove(id, i);
+        if (i < id.size())
+            indexOf[id[i]] = (int)i;
+    }
+
+    // Remove todos os asteroides i com dead[i] != 0 (veja SwapCompact())
+    void compact(const std::vector<unsigned char>& dead) {
+        size_t n = SwapCompact(dead, size(),
+            [&](size_t i) { indexOf[id[i]] = -1; },
+            [&](size_t from, size_t to) {
+                x[to] = x[from]; y[to] = y[from]; z[to] = z[from];
+                id[to] = id[from];
+                indexOf[id[to]] = (int)to;
+            });
+        x.resize(n); y.resize(n); z.resize(n);
+        id.resize(n);
+    }
+
+    // Volta a numerar os ids na ordem atual (0 .. size()-1)
+    void renumber() {
+        indexOf.resize(size());
+        for (size_t i = 0; i < size(); ++i) {
+            id[i] = (unsigned int)i;
+            indexOf[i] = (int)i;
+        }
+    }
+
+    glm::vec4 position(size_t i) const { return glm::vec4(x[i], y[i], z[i], 1.0f); }
+};
+
+struct MeshCollider;
+
+// Volumes de colisão de um tipo de entidade, no referencial da entidade: a
+// origem é a posição dela, X aponta para a direita, Y para fora da lua e Z
+// para a frente, como na renderização. Sem volumes ajustados (fitted ==
+// false), as colisões usam as esferas e cilindros de raios fixos de
+// "collisions.h".
+struct EntityBounds {
+    bool fitted;
+    MeshBounds local;
+    float reach;          // Distância máxima da origem até a esfera envolvente
+    const MeshCollider* mesh; // Triângulos da malha (opcional, veja Sim_SetAircraftMesh())
+
+    EntityBounds() : fitted(false), reach(0.0f), mesh(NULL) {}
+};
+
+// Entradas do jogador em um passo de simulação
+struct SimInput {
+    bool forward;     // W: avança
+    bool left;        // A: gira para a esquerda (somente avançando)
+    bool right;       // D: gira para a direita (somente avançando)
+    bool fire;        // Espaço: dispara um míssil, se a recarga permitir
+    bool running;     // I: jogo iniciado (false = pausado)
+    bool freeFlight;  // B: voo livre de demonstração, sem lógica de jogo
+};
+
+// Contato encontrado pelos testes de colisão de um passo. Os testes só leem o
+// estado e guardam os contatos; as consequências (dano, remoções) são
+// aplicadas depois, todas juntas (veja processCollisions()). Os índices são
+// os das entidades antes das remoções do passo.
+enum CollisionEventType {
+    COLLISION_AIRCRAFT_ENEMY,    // target: inimigo tocado pela nave
+    COLLISION_CHECKPOINT,        // target: checkpoint coletado
+    COLLISION_AIRCRAFT_ASTEROID, // target: asteroide tocado pela nave
+    COLLISION_MISSILE_ENEMY,     // source: míssil da nave, target: inimigo
+    COLLISION_MISSILE_AIRCRAFT,  // source: míssil de um inimigo, target: 0 (a nave)
+    COLLISION_MISSILE_ASTEROID   // source: míssil, target: asteroide
+};
+
+struct CollisionEvent {
+    unsigned int type;    // CollisionEventType
+    unsigned int source;
+    unsigned int target;
+    float t;              // Instante do contato, de 0 (início do passo) a 1 (fim)
+};
+
+// Estado completo de uma partida
+struct GameState {
+    glm::vec4 aircraftPosition;
+    glm::vec4 aircraftForward;
+    glm::vec4 aircraftPositionPrev; // Estado da nave no passo anterior
+    glm::vec4 aircraftForwardPrev;
+    int aircraftLife;
+    bool isGameOver;
+
+    EnemyArray enemies;
+    std::vector<glm::vec4> checkpoints;     // Posições dos 5 checkpoints
+    AsteroidArray randomAsteroids;
+    MissilePool missiles;
+
+    float asteroidT;       // Parâmetro do asteroide na curva de Bézier
+    float asteroidTPrev;
+
+    bool isDamaged;        // Feedback de dano (nave vermelha) ativo
+    bool playerReloading;  // Nave aguardando o intervalo entre tiros
+    double time;           // Tempo de jogo (sem pausas) desde Sim_Reset(), em segundos
+
+    // Eventos agendados, em ticks de 1/60 s de tempo de jogo: tiros dos
+    // inimigos, fim da vida dos mísseis, fim do feedback de dano e fim do
+    // intervalo entre tiros da nave
+    TimerWheel timers;
+    TimerHandle damageTimer;
+    std::vector<TimerEvent> dueTimers;  // Vetor reaproveitado a cada passo
+
+    // Contatos das colisões do passo e entidades a remover depois deles.
+    // Vetores reaproveitados a cada passo (alocados na primeira partida).
+    std::vector<CollisionEvent> collisionEvents;
+    std::vector<unsigned int> missileEvents;  // Primeiro contato de cada míssil em collisionEvents
+    std::vector<unsigned char> enemyDead, checkpointDead, asteroidDead, missileDead;
+
+    // Broadphase de colisões com muitos inimigos, reconstruída a cada passo.
+    // Os itens da grade são ids (veja EnemyArray), válidos mesmo depois das
+    // remoções do próprio passo.
+    SphereGrid enemyGrid;
+
+    // BVH do campo de asteroides (itens são ids de randomAsteroids), montada
+    // com os asteroides e atualizada a cada asteroide destruído
+    Bvh asteroidBvh;
+
+    // Volumes ajustados às malhas (Sim_SetMeshBounds), mantidos por Sim_Reset()
+    EntityBounds aircraftBounds;   // Nave e inimigos (aircraft.obj)
+    EntityBounds asteroidBounds;   // Asteroides aleatórios (asteroid.obj)
+
+    unsigned int rng;      // Estado do gerador de números aleatórios
+};
+
+// Parâmetros fixos do cenário
+extern const glm::vec4 moon_position;
+extern const float orbitDistance;
+extern const float asteroidScale;
+extern const float missileRadius;
+
+// Reinicia a partida. A posição dos inimigos e asteroides é sorteada pelo
+// gerador do próprio estado, iniciado com "seed": a mesma semente sempre gera
+// a mesma partida.
+void Sim_Reset(GameState& state, unsigned int seed);
+
+// Passa a usar nas colisões os volumes ajustados às malhas da nave (usada
+// também pelos inimigos) e dos asteroides, já no referencial das entidades
+// (veja EntityBounds). Um contato exige que a esfera envolvente e o volume
+// orientado (a cápsula das naves, a caixa dos asteroides) sejam tocados.
+void Sim_SetMeshBounds(GameState& state, const MeshBounds& aircraft, const MeshBounds& asteroid);
+
+// Acrescenta aos volumes ajustados da nave e dos inimigos um último teste
+// contra os triângulos da malha ("meshcollider.h"), no mesmo referencial, para
+// os contatos que já tocaram a esfera envolvente e a cápsula. Sem efeito sem
+// Sim_SetMeshBounds(). A malha não é copiada e precisa continuar existindo
+// enquanto for usada; NULL desliga o teste.
+void Sim_SetAircraftMesh(GameState& state, const MeshCollider* mesh);
+
+struct JobSystem;
+
+// Avança a partida em delta_t segundos com as entradas "input". Com "jobs",
+// partidas com muitas entidades dividem o movimento e os testes de colisão
+// entre as threads do sistema de tarefas; o resultado é o mesmo que sem ele.
+void Sim_Step(GameState& state, const SimInput& input, float delta_t, JobSystem* jobs = NULL);
+
+// Somente os testes de colisão de Sim_Step() e suas consequências (dano,
+// remoções), entre as posições do passo anterior e as atuais, sem mover nada.
+// Usada para medir as colisões isoladas ("bench_collisions.cpp").
+void Sim_ProcessCollisions(GameState& state, JobSystem* jobs = NULL);
+
+// Testa se a partida acabou (sem vida ou sem checkpoints restantes)
+bool Sim_IsGameOver(GameState& state);
+
+// Posição do asteroide que percorre a curva de Bézier, no parâmetro t
+glm::vec4 Sim_AsteroidBezierPosition(float t);
+
+// Interpolação entre o estado anterior e o atual, para a renderização
+glm::vec4 Sim_InterpolateOrbitPosition(const glm::vec4& prev, const glm::vec4& curr, float alpha);
+glm::vec4 Sim_InterpolateDirection(const glm::vec4& prev, const glm::vec4& curr, float alpha);
+
+// Referencial de uma entidade na órbita, como na renderização (veja
+// EntityBounds): colunas direita, cima (para fora da lua), frente e posição
+glm::mat4 Sim_OrbitFrame(const glm::vec4& position, const glm::vec4& forward);
+
+glm::vec4 normalizedVec(glm::vec4 v);
+
+#endif // _SIMULATION_H
@@ -0,0 +1,75 @@
+#ifndef _SPHEREGRID_H
+#define _SPHEREGRID_H
+
+#include <cstddef>
+#include <vector>
+
+#include <glm/vec4.hpp>
+
+// Grade espacial sobre a esfera (broadphase de colisões na órbita). A esfera
+// é dividida como um cubo projetado ("cube-sphere"): cada uma das 6 faces tem
+// resolution x resolution células. As coordenadas de cada face são ângulos
+// (projeção equiangular), então todas as células têm aproximadamente o mesmo
+// tamanho, e o raio da esfera não importa, somente a direção a partir do
+// centro.
+//
+// A grade é reconstruída a cada passo com uma ordenação por contagem: as
+// entidades ficam agrupadas por célula em items (e as posições, na mesma
+// ordem, em x, y, z), e as células de uma mesma linha de uma face ficam
+// contíguas. Uma consulta visita somente as células que a esfera consultada
+// pode tocar, então o custo depende do número de entidades próximas, e não do
+// total.
+
+#define SPHEREGRID_FACES 6
+
+struct SphereGrid {
+    glm::vec4 center;
+    int resolution;                       // Células por aresta de cada face
+    std::vector<unsigned int> cellStart;  // Início de cada célula em items (+1 no fim)
+    std::vector<unsigned int> cellOf;     // Célula de cada entidade (construção)
+    std::vector<unsigned int> items;      // Índice das entidades, ordenadas por célula
+    std::vector<float> x, y, z;           // Posições na ordem de items
+};
+
+// Retângulo de células de uma face: colunas [u0, u1] e linhas [v0, v1]
+struct SphereGridRange {
+    int face;
+    int u0, u1, v0, v1;
+};
+
+void SphereGrid_Init(SphereGrid& grid, const glm::vec4& center, int resolution);
+
+// Célula da direção do ponto (x, y, z) a partir do centro
+unsigned int SphereGrid_Cell(const SphereGrid& grid, float x, float y, float z);
+
+// Reconstrói a grade com as n entidades de posições x, y, z. Dentro de cada
+// célula, as entidades ficam em ordem crescente de índice.
+void SphereGrid_Build(SphereGrid& grid, const float* x, const float* y, const float* z, size_t n);
+
+// Retângulos de células (no máximo um por face) que contêm todas as entidades
+// a até "radius" do ponto p. Devolve o número de retângulos escritos.
+int SphereGrid_Ranges(const SphereGrid& grid, const glm::vec4& p, float radius,
+                      SphereGridRange ranges[SPHEREGRID_FACES]);
+
+// Chama visit(k) para cada entidade k (posição em items, x, y, z) das células
+// que podem conter entidades a até "radius" de p. Cada entidade é visitada uma
+// única vez; quem chama faz o teste exato.
+template <typename Visit>
+inline void SphereGrid_Query(const SphereGrid& grid, const glm::vec4& p, float radius, const Visit& visit) {
+    SphereGridRange ranges[SPHEREGRID_FACES];
+    int count = SphereGrid_Ranges(grid, p, radius, ranges);
+    int r = grid.resolution;
+
+    for (int f = 0; f < count; ++f) {
+        const SphereGridRange& range = ranges[f];
+        for (int v = range.v0; v <= range.v1; ++v) {
+            unsigned int row = (unsigned int)((range.face * r + v) * r);
+            unsigned int begin = grid.cellStart[row + range.u0];
+            unsigned int end = grid.cellStart[row + range.u1 + 1];
+            for (unsigned int k = begin; k < end; ++k)
+                visit(k);
+        }
+    }
+}
+
+#endif // _SPHEREGRID_H
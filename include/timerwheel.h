@@ -0,0 +1,67 @@
+#ifndef _TIMERWHEEL_H
+#define _TIMERWHEEL_H
+
+#include <cstddef>
+#include <vector>
+
+// Agendador de eventos em "roda de temporizadores" hierárquica. O tempo é
+// contado em ticks inteiros (na simulação, passos de 1/60 s). Cada evento
+// agendado fica em uma lista de uma das TIMERWHEEL_LEVELS rodas: a roda 0
+// tem uma posição por tick dos próximos 64 ticks, a roda 1 uma posição por
+// bloco de 64 ticks, e assim por diante. Ao avançar o tempo, somente a
+// posição do tick atual é visitada (e, a cada 64 ticks, uma posição da roda
+// seguinte é redistribuída), então o custo de cada tick depende apenas do
+// número de eventos vencidos, e não do número de eventos agendados.
+//
+// Os eventos não chamam funções: TimerWheel_Advance() devolve os vencidos em
+// um vetor, e quem chamou decide o que fazer com cada um pelo tipo e pelos
+// dados (ex.: índice de um inimigo, handle de um míssil).
+
+#define TIMERWHEEL_SLOT_BITS 6
+#define TIMERWHEEL_SLOTS     (1 << TIMERWHEEL_SLOT_BITS)
+#define TIMERWHEEL_LEVELS    4  // Atrasos de até 64^4 ticks (mais de 3 dias a 60 Hz)
+
+struct TimerEvent {
+    unsigned int type;  // Definido por quem agenda
+    unsigned int a, b;  // Dados do evento
+};
+
+struct TimerHandle {
+    unsigned int node;
+    unsigned int generation; // 0: handle inválido
+};
+
+struct TimerNode {
+    TimerEvent event;
+    unsigned int expires;    // Tick em que o evento vence
+    unsigned int generation;
+    int prev, next;          // Lista duplamente ligada da posição (ou de nós livres)
+    int slot;                // Posição em slots, -1 se o nó está livre
+};
+
+struct TimerWheel {
+    unsigned int now;                     // Tick atual
+    std::vector<int> slots;               // Primeiro nó de cada posição, -1 se vazia
+    std::vector<TimerNode> nodes;         // Nós reaproveitados pela lista de livres
+    int freeList;
+    size_t count;                         // Eventos agendados
+};
+
+// Remove todos os eventos e volta ao tick 0. A memória dos nós é mantida.
+void TimerWheel_Reset(TimerWheel& wheel);
+
+// Agenda "event" para daqui a "delay" ticks (no mínimo 1)
+TimerHandle TimerWheel_Schedule(TimerWheel& wheel, unsigned int delay, const TimerEvent& event);
+
+// Cancela um evento ainda não vencido. Devolve false se ele já venceu ou foi
+// cancelado.
+bool TimerWheel_Cancel(TimerWheel& wheel, TimerHandle handle);
+
+// Avança até o tick "now", acrescentando em "due" os eventos vencidos, tick
+// por tick. A ordem dos eventos de um mesmo tick é fixa (não depende do
+// horário nem da máquina), mas não é a ordem em que foram agendados.
+void TimerWheel_Advance(TimerWheel& wheel, unsigned int now, std::vector<TimerEvent>& due);
+
+size_t TimerWheel_Count(const TimerWheel& wheel);
+
+#endif // _TIMERWHEEL_H
@@ -0,0 +1,199 @@
+// Execução de várias partidas em paralelo. Veja "batchsim.h".
+#include <cmath>
+#include <algorithm>
+
+#include "batchsim.h"
+#include "matrices.h"
+
+// Recompensas de cada evento da partida
+const float rewardCheckpoint = 1.0f;  // Por checkpoint coletado
+const float rewardLifeLost   = -1.0f; // Por vida perdida
+const float rewardWin        = 10.0f; // Todos os checkpoints coletados
+const float rewardLose       = -10.0f; // Sem vida
+
+// Semente da partida "index" a partir da semente do lote (hash de Wang), para
+// que partidas vizinhas não tenham sequências aleatórias correlacionadas.
+static unsigned int BatchSim_Seed(unsigned int seed, unsigned int index)
+{
+    unsigned int x = seed ^ (index * 0x9E3779B9u);
+    x = (x ^ 61u) ^ (x >> 16);
+    x *= 9u;
+    x ^= x >> 4;
+    x *= 0x27d4eb2du;
+    x ^= x >> 15;
+    return x;
+}
+
+// Guarda em "out" (count entradas de 4 floats) as posições, relativas à nave
+// e nos eixos locais dela, das "count" entidades mais próximas entre as n de
+// "entities" (qualquer tipo com position(i)).
+template <typename Entities>
+static void BatchSim_WriteNearest(float* out, int count, const Entities& entities, size_t n,
+                                  const glm::vec4& origin, const glm::vec4& right, const glm::vec4& up, const glm::vec4& front)
+{
+    // Índices das mais próximas, ordenados por distância (seleção parcial).
+    // count é no máximo 8.
+    int   nearest[8];
+    float nearest_d2[8];
+    int   found = 0;
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        glm::vec4 d = entities.position(i) - origin;
+        float d2 = d.x*d.x + d.y*d.y + d.z*d.z;
+
+        if (found == count && d2 >= nearest_d2[found - 1])
+            continue;
+
+        int j = (found < count) ? found++ : found - 1;
+        while (j > 0 && nearest_d2[j - 1] > d2)
+        {
+            nearest[j] = nearest[j - 1];
+            nearest_d2[j] = nearest_d2[j - 1];
+            --j;
+        }
+        nearest[j] = (int)i;
+        nearest_d2[j] = d2;
+    }
+
+    for (int k = 0; k < count; ++k)
+    {
+        float* o = out + 4*k;
+        if (k < found)
+        {
+            glm::vec4 d = entities.position(nearest[k]) - origin;
+            d.w = 0.0f;
+            o[0] = dotproduct(d, right) / orbitDistance;
+            o[1] = dotproduct(d, up)    / orbitDistance;
+            o[2] = dotproduct(d, front) / orbitDistance;
+            o[3] = 1.0f;
+        }
+        else
+        {
+            o[0] = o[1] = o[2] = o[3] = 0.0f;
+        }
+    }
+}
+
+// Acesso aos checkpoints com a mesma interface de EnemyArray e AsteroidArray
+struct CheckpointPositions
+{
+    const std::vector<glm::vec4>& points;
+    glm::vec4 position(size_t i) const { return points[i]; }
+};
+
+static void BatchSim_Observe(const GameState& state, float* obs)
+{
+    const glm::vec4& pos = state.aircraftPosition;
+    glm::vec4 up = normalizedVec(pos - moon_position);
+    glm::vec4 front = state.aircraftForward;
+    glm::vec4 right = normalizedVec(crossproduct(up, front));
+
+    obs[0] = (pos.x - moon_position.x) / orbitDistance;
+    obs[1] = (pos.y - moon_position.y) / orbitDistance;
+    obs[2] = (pos.z - moon_position.z) / orbitDistance;
+    obs[3] = front.x;
+    obs[4] = front.y;
+    obs[5] = front.z;
+    obs[6] = (float)state.aircraftLife / (float)MAX_LIFE;
+
+    float* o = obs + BATCHSIM_SHIP_OBS_SIZE;
+    BatchSim_WriteNearest(o, BATCHSIM_NEAREST_ENEMIES, state.enemies, state.enemies.size(), pos, right, up, front);
+    o += 4 * BATCHSIM_NEAREST_ENEMIES;
+    BatchSim_WriteNearest(o, BATCHSIM_NEAREST_ASTEROIDS, state.randomAsteroids, state.randomAsteroids.size(), pos, right, up, front);
+    o += 4 * BATCHSIM_NEAREST_ASTEROIDS;
+    CheckpointPositions checkpoints = { state.checkpoints };
+    BatchSim_WriteNearest(o, BATCHSIM_NEAREST_CHECKPOINTS, checkpoints, state.checkpoints.size(), pos, right, up, front);
+}
+
+// Avança as partidas [begin, end). Cada partida só é acessada por uma thread.
+static void BatchSim_StepRange(BatchSim& batch, size_t begin, size_t end)
+{
+    SimInput input = {};
+    input.running = true;
+
+    for (size_t i = begin; i < end; ++i)
+    {
+        GameState& state = batch.states[i];
+        unsigned char action = batch.actions[i];
+
+        input.forward = (action & BATCHSIM_FORWARD) != 0;
+        input.left    = (action & BATCHSIM_LEFT) != 0;
+        input.right   = (action & BATCHSIM_RIGHT) != 0;
+        input.fire    = (action & BATCHSIM_FIRE) != 0;
+
+        size_t checkpoints_before = state.checkpoints.size();
+        int life_before = state.aircraftLife;
+
+        Sim_Step(state, input, batch.delta_t);
+        batch.episode_steps[i] += 1;
+
+        float reward = rewardCheckpoint * (float)(checkpoints_before - state.checkpoints.size());
+        if (state.aircraftLife < life_before)
+            reward += rewardLifeLost * (float)(life_before - state.aircraftLife);
+
+        bool done = false;
+        if (Sim_IsGameOver(state))
+        {
+            reward += state.aircraftLife <= 0 ? rewardLose : rewardWin;
+            done = true;
+        }
+        else if (batch.episode_steps[i] >= batch.max_episode_steps)
+        {
+            done = true;
+        }
+
+        if (done)
+        {
+            // A semente da nova partida depende somente do índice e do
+            // gerador da partida que terminou, e não da ordem das threads.
+            Sim_Reset(state, BatchSim_Seed(batch.seed, (unsigned int)i) ^ state.rng);
+            batch.episode_steps[i] = 0;
+        }
+
+        batch.rewards[i] = reward;
+        batch.dones[i] = done ? 1 : 0;
+        BatchSim_Observe(state, &batch.observations[i * BATCHSIM_OBS_SIZE]);
+    }
+}
+
+void BatchSim_Init(BatchSim& batch, size_t num_envs, unsigned int seed, int num_threads)
+{
+    JobSystem_Init(batch.jobs, num_threads);
+
+    batch.delta_t = 1.0f / 60.0f;
+    batch.max_episode_steps = 60 * 120;
+    batch.num_threads = JobSystem_ThreadCount(batch.jobs);
+    batch.seed = seed;
+
+    batch.states.resize(num_envs);
+    batch.actions.assign(num_envs, 0);
+    batch.observations.assign(num_envs * BATCHSIM_OBS_SIZE, 0.0f);
+    batch.rewards.assign(num_envs, 0.0f);
+    batch.dones.assign(num_envs, 0);
+    batch.episode_steps.assign(num_envs, 0);
+
+    for (size_t i = 0; i < num_envs; ++i)
+    {
+        Sim_Reset(batch.states[i], BatchSim_Seed(seed, (unsigned int)i));
+        BatchSim_Observe(batch.states[i], &batch.observations[i * BATCHSIM_OBS_SIZE]);
+    }
+}
+
+void BatchSim_Step(BatchSim& batch)
+{
+    size_t n = batch.states.size();
+
+    // Blocos menores que n / threads: partidas que reiniciam ou têm mais
+    // mísseis demoram mais, e as threads livres roubam os blocos restantes
+    size_t grain = std::max((size_t)16, n / ((size_t)batch.num_threads * 8));
+
+    JobSystem_ParallelFor(batch.jobs, n, grain, [&batch](size_t begin, size_t end) {
+        BatchSim_StepRange(batch, begin, end);
+    });
+}
+
+size_t BatchSim_Count(const BatchSim& batch)
+{
+    return batch.states.size();
+}
@@ -0,0 +1,73 @@
+// Mede a vazão de BatchSim_Step(), em passos de partida por segundo
+// ("env-steps/s"), sem janela nem GPU.
+//
+// Uso: bench_batchsim [partidas] [passos] [threads]
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+
+#include "batchsim.h"
+
+// Lê o inteiro "text" em "value". Devolve false se o texto não for um número
+// ou se o valor for menor que "min".
+static bool ParseCount(const char* text, long min, long& value)
+{
+    char* end;
+    value = strtol(text, &end, 10);
+    return end != text && *end == '\0' && value >= min;
+}
+
+int main(int argc, char* argv[])
+{
+    long envs = 1024, steps = 600, threads = 0;
+    if ((argc > 1 && !ParseCount(argv[1], 1, envs))
+        || (argc > 2 && !ParseCount(argv[2], 1, steps))
+        || (argc > 3 && !ParseCount(argv[3], 0, threads)))
+    {
+        fprintf(stderr, "Uso: bench_batchsim [partidas] [passos] [threads]\n"
+                        "     partidas e passos > 0, threads >= 0 (0 = todos os núcleos)\n");
+        return EXIT_FAILURE;
+    }
+
+    size_t num_envs = (size_t)envs;
+    int num_steps   = (int)steps;
+    int num_threads = (int)threads;
+
+    BatchSim batch;
+    BatchSim_Init(batch, num_envs, 12345u, num_threads);
+
+    // Ações pseudo-aleatórias (sempre avançando), trocadas a cada passo
+    unsigned int rng = 1u;
+
+    size_t episodes = 0;
+    double total_reward = 0.0;
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    for (int step = 0; step < num_steps; ++step)
+    {
+        for (size_t i = 0; i < num_envs; ++i)
+        {
+            rng = rng * 1664525u + 1013904223u;
+            batch.actions[i] = BATCHSIM_FORWARD | ((rng >> 24) & (BATCHSIM_LEFT | BATCHSIM_RIGHT | BATCHSIM_FIRE));
+        }
+
+        BatchSim_Step(batch);
+
+        for (size_t i = 0; i < num_envs; ++i)
+        {
+            episodes += batch.dones[i];
+            total_reward += batch.rewards[i];
+        }
+    }
+
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(end - start).count();
+    double env_steps = (double)num_envs * num_steps;
+
+    printf("partidas: %zu  passos: %d  threads: %d\n", num_envs, num_steps, batch.num_threads);
+    printf("tempo: %.3f s  env-steps/s: %.0f\n", seconds, env_steps / seconds);
+    printf("partidas encerradas: %zu  recompensa total: %.1f\n", episodes, total_reward);
+
+    return 0;
+}
@@ -0,0 +1,825 @@
+// Mede os testes de colisão de "collisions.h", as broadphases (grade sobre a
+// esfera e BVH) e a passada completa de colisões da simulação, com N
+// entidades espalhadas na casca da órbita. As posições vêm de um gerador com
+// semente fixa: o mesmo N sempre gera as mesmas entidades, então os
+// resultados de duas versões do código podem ser comparados.
+//
+// Cada linha do resultado tem o número de testes de uma execução, os pares
+// de formas testados, os contatos encontrados e o tempo por teste:
+//   - teste:  tests = pares = 64 consultas x N entidades, cada par com a função;
+//   - broad:  montagem (tests = N itens) ou consultas (tests = 64 consultas,
+//             pares = candidatos devolvidos e testados com a forma exata);
+//   - passada: Sim_ProcessCollisions() com N inimigos, N/2 mísseis e N/4
+//             asteroides (tests = 1 passada, contatos = eventos de colisão);
+//   - consulta: as consultas de "scenequery.h" (raio e esfera) nessa mesma
+//             cena e, com o sufixo "_loop", o mesmo resultado calculado com
+//             laços sobre todas as entidades (tests = 64 consultas,
+//             contatos = alvos devolvidos).
+//
+// Os testes em lote também são conferidos com os testes de um par por vez, e
+// as consultas com os laços (o resultado deve ser o mesmo), e o programa
+// termina com erro se houver diferença. O programa bench_collisions_avx é o
+// mesmo, com a simulação compilada com AVX: os dois juntos conferem os
+// caminhos AVX, SSE2 e escalar dos testes em lote.
+//
+// Uso: bench_collisions [--json] [entidades]
+//      sem número, mede 10, 100, 1000, 10000 e 100000 entidades.
+//      Com --json, escreve os resultados em JSON em vez da tabela.
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include "collisions.h"
+#include "simulation.h"
+#include "spheregrid.h"
+#include "bvh.h"
+#include "scenequery.h"
+#include "matrices.h"
+
+// Consultas (esferas de míssil) testadas contra as N entidades
+static const size_t numQueries = 64;
+
+// Deslocamento em um passo: inimigos e mísseis (missileSpeed / 60)
+static const float enemyStep = 0.05f;
+static const float missileStep = 20.0f / 60.0f;
+
+// Cada medição repete o trabalho até somar cerca deste número de testes
+static const double targetTests = 4e6;
+
+// Alcance dos raios e raio das esferas das consultas da cena
+static const float queryRayDistance = 30.0f;
+static const float querySphereRadius = 2.0f;
+
+// Entidades na casca da órbita: posição atual, posição no passo anterior e
+// direção (tangente à órbita)
+struct Shell
+{
+    std::vector<float> x, y, z;
+    std::vector<float> prev_x, prev_y, prev_z;
+    std::vector<glm::vec4> forward;
+
+    size_t size() const { return x.size(); }
+    glm::vec4 position(size_t i) const { return glm::vec4(x[i], y[i], z[i], 1.0f); }
+    glm::vec4 prevPosition(size_t i) const { return glm::vec4(prev_x[i], prev_y[i], prev_z[i], 1.0f); }
+};
+
+static float Random(unsigned int& rng)
+{
+    rng = rng * 1664525u + 1013904223u;
+    return (float)(rng >> 8) / 8388608.0f - 1.0f;
+}
+
+static glm::vec4 Normalized(const glm::vec4& v)
+{
+    return v / norm(v);
+}
+
+// n entidades em pontos pseudo-aleatórios da casca (raio da órbita, com até
+// 0.2 de variação), que se moveram "step" ao longo da direção no último passo
+static void MakeShell(Shell& shell, size_t n, unsigned int seed, float step)
+{
+    shell.x.resize(n); shell.y.resize(n); shell.z.resize(n);
+    shell.prev_x.resize(n); shell.prev_y.resize(n); shell.prev_z.resize(n);
+    shell.forward.resize(n);
+
+    unsigned int rng = seed;
+    for (size_t i = 0; i < n; ++i)
+    {
+        float v[7];
+        for (int k = 0; k < 7; ++k)
+            v[k] = Random(rng);
+
+        glm::vec4 p = Normalized(glm::vec4(v[0], v[1], v[2], 0.0f));
+        glm::vec4 f = glm::vec4(v[3], v[4], v[5], 0.0f);
+        f = Normalized(f - dotproduct(f, p) * p);
+
+        glm::vec4 position = moon_position + (orbitDistance + 0.2f * v[6]) * p;
+        glm::vec4 prev = position - step * f;
+
+        shell.x[i] = position.x; shell.y[i] = position.y; shell.z[i] = position.z;
+        shell.prev_x[i] = prev.x; shell.prev_y[i] = prev.y; shell.prev_z[i] = prev.z;
+        shell.forward[i] = f;
+    }
+}
+
+struct Result
+{
+    const char* group;
+    const char* name;
+    size_t n;
+    int runs;
+    double tests;   // Por execução
+    double pairs;   // Por execução; < 0 se não medido
+    double hits;    // Por execução
+    double ms;      // Tempo total das execuções
+};
+
+static std::vector<Result> g_Results;
+
+// Conferência de um resultado com o de uma versão mais simples: um teste em
+// lote com o teste de um par por vez, ou uma consulta da cena com os laços
+struct Check
+{
+    const char* group;
+    const char* name;
+    size_t n;
+    double tests;
+    size_t mismatches;
+};
+
+static std::vector<Check> g_Checks;
+
+static int Runs(double tests)
+{
+    double runs = targetTests / (tests > 1.0 ? tests : 1.0);
+    return runs < 1.0 ? 1 : (runs > 100000.0 ? 100000 : (int)runs);
+}
+
+// Tempo total, em milissegundos, de "runs" chamadas de body()
+template <typename Body>
+static double TimeMs(int runs, const Body& body)
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int r = 0; r < runs; ++r)
+        body();
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+static void AddResult(const char* group, const char* name, size_t n, int runs,
+                      double tests, double pairs, double hits, double ms)
+{
+    Result result = { group, name, n, runs, tests, pairs, hits, ms };
+    g_Results.push_back(result);
+}
+
+// Testa cada consulta contra cada entidade com test(q, i), que devolve true
+// nos contatos
+template <typename Test>
+static void MeasureTest(const char* name, size_t n, const Test& test)
+{
+    double tests = (double)numQueries * n;
+    int runs = Runs(tests);
+    size_t hits = 0;
+
+    double ms = TimeMs(runs, [&]() {
+        hits = 0;
+        for (size_t q = 0; q < numQueries; ++q)
+            for (size_t i = 0; i < n; ++i)
+                hits += test(q, i) ? 1 : 0;
+    });
+    AddResult("teste", name, n, runs, tests, tests, (double)hits, ms);
+}
+
+// Mesmo que MeasureTest(), com uma consulta contra todas as entidades por
+// chamada de test(q), que devolve o número de contatos
+template <typename Test>
+static void MeasureBatch(const char* name, size_t n, const Test& test)
+{
+    double tests = (double)numQueries * n;
+    int runs = Runs(tests);
+    size_t hits = 0;
+
+    double ms = TimeMs(runs, [&]() {
+        hits = 0;
+        for (size_t q = 0; q < numQueries; ++q)
+            hits += test(q);
+    });
+    AddResult("teste", name, n, runs, tests, tests, (double)hits, ms);
+}
+
+// Compara, para cada consulta, a máscara devolvida por batch(q, hits) com
+// test(q, i) em cada entidade, e guarda o número de diferenças
+template <typename Batch, typename Test>
+static void CheckBatch(const char* name, size_t n, const Batch& batch, const Test& test)
+{
+    std::vector<unsigned int> hits(COLLISION_MASK_WORDS(n));
+    size_t mismatches = 0;
+    for (size_t q = 0; q < numQueries; ++q)
+    {
+        size_t count = batch(q, hits.data());
+        size_t expected = 0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            bool hit = (hits[i / 32] >> (i % 32)) & 1u;
+            bool reference = test(q, i);
+            expected += reference ? 1 : 0;
+            mismatches += (hit != reference) ? 1 : 0;
+        }
+        mismatches += (count != expected) ? 1 : 0;
+    }
+    Check check = { "lote", name, n, (double)numQueries * n, mismatches };
+    g_Checks.push_back(check);
+}
+
+static void MeasureTests(size_t n, const Shell& entities, const Shell& queries)
+{
+    std::vector<BoundingSphere> spheres(n);
+    std::vector<BoundingCylinder> cylinders(n);
+    std::vector<BoundingCapsule> capsules(n);
+    std::vector<BoundingOBB> boxes(n);
+    std::vector<glm::vec4> triangles(3 * n);
+
+    // Volumes de cada entidade no referencial dela, com medidas parecidas com
+    // as da nave e dos asteroides do jogo
+    for (size_t i = 0; i < n; ++i)
+    {
+        glm::vec4 p = entities.position(i);
+        glm::mat4 frame = Sim_OrbitFrame(p, entities.forward[i]);
+
+        spheres[i].center = p;
+        spheres[i].radius = AIRCRAFT_SPHERE_RADIUS;
+        cylinders[i] = getAsteroidBoundingCylinder(p);
+
+        capsules[i].a = p - 0.4f * frame[2];
+        capsules[i].b = p + 0.4f * frame[2];
+        capsules[i].radius = 0.1f;
+
+        boxes[i].center = p;
+        const float half[3] = { 0.4f, 0.1f, 0.5f };
+        for (int a = 0; a < 3; ++a)
+        {
+            boxes[i].axis[a] = frame[a];
+            boxes[i].halfSize[a] = half[a];
+        }
+
+        triangles[3 * i + 0] = p + 0.5f * frame[0];
+        triangles[3 * i + 1] = p - 0.5f * frame[0];
+        triangles[3 * i + 2] = p + 0.5f * frame[2];
+    }
+
+    std::vector<BoundingSphere> missiles(numQueries);
+    std::vector<Ray> rays(numQueries);
+    std::vector<Ray> segments(numQueries);
+    for (size_t q = 0; q < numQueries; ++q)
+    {
+        missiles[q].center = queries.prevPosition(q);
+        missiles[q].radius = missileRadius;
+        rays[q].origin = queries.prevPosition(q);
+        rays[q].direction = queries.forward[q];
+        segments[q].origin = queries.prevPosition(q);
+        segments[q].direction = queries.position(q) - queries.prevPosition(q);
+    }
+
+    MeasureTest("sphere_sphere", n, [&](size_t q, size_t i) {
+        return checkSphereSphereCollision(missiles[q], spheres[i]);
+    });
+    MeasureTest("ray_sphere", n, [&](size_t q, size_t i) {
+        float t;
+        return checkRaySphereCollision(rays[q], spheres[i], t);
+    });
+    MeasureTest("cylinder_sphere", n, [&](size_t q, size_t i) {
+        return checkCylinderSphereCollision(cylinders[i], missiles[q]);
+    });
+    MeasureTest("capsule_sphere", n, [&](size_t q, size_t i) {
+        return checkCapsuleSphereCollision(capsules[i], missiles[q]);
+    });
+    MeasureTest("obb_sphere", n, [&](size_t q, size_t i) {
+        return checkOBBSphereCollision(boxes[i], missiles[q]);
+    });
+    MeasureTest("ray_obb", n, [&](size_t q, size_t i) {
+        float t;
+        return checkRayOBBCollision(rays[q], boxes[i], t);
+    });
+    MeasureTest("triangle_sphere", n, [&](size_t q, size_t i) {
+        return checkTriangleSphereCollision(triangles[3 * i], triangles[3 * i + 1], triangles[3 * i + 2], missiles[q]);
+    });
+    MeasureTest("segment_triangle", n, [&](size_t q, size_t i) {
+        float t;
+        return checkRayTriangleCollision(segments[q], triangles[3 * i], triangles[3 * i + 1], triangles[3 * i + 2], t)
+            && t <= 1.0f;
+    });
+    MeasureTest("swept_sphere_sphere", n, [&](size_t q, size_t i) {
+        BoundingSphere enemy = { entities.prevPosition(i), AIRCRAFT_SPHERE_RADIUS };
+        float t;
+        return checkSweptSphereSphereCollision(missiles[q], queries.position(q), enemy, spheres[i].center, t);
+    });
+    MeasureTest("swept_cylinder_sphere", n, [&](size_t q, size_t i) {
+        float t;
+        return checkSweptCylinderSphereCollision(cylinders[i], missiles[q], queries.position(q), t);
+    });
+
+    MeasureBatch("sphere_sphere_batch", n, [&](size_t q) {
+        return checkSphereSphereBatch(missiles[q], entities.x.data(), entities.y.data(), entities.z.data(),
+                                      AIRCRAFT_SPHERE_RADIUS, n, NULL);
+    });
+    MeasureBatch("ray_sphere_batch", n, [&](size_t q) {
+        return checkRaySphereBatch(rays[q], entities.x.data(), entities.y.data(), entities.z.data(),
+                                   AIRCRAFT_SPHERE_RADIUS, n, NULL, NULL);
+    });
+    MeasureBatch("cylinder_sphere_batch", n, [&](size_t q) {
+        return checkCylinderSphereBatch(missiles[q], entities.x.data(), entities.y.data(), entities.z.data(),
+                                        ASTEROID_CYLINDER_RADIUS, ASTEROID_CYLINDER_HEIGHT, n, NULL);
+    });
+
+    CheckBatch("sphere_sphere_batch", n, [&](size_t q, unsigned int* hits) {
+        return checkSphereSphereBatch(missiles[q], entities.x.data(), entities.y.data(), entities.z.data(),
+                                      AIRCRAFT_SPHERE_RADIUS, n, hits);
+    }, [&](size_t q, size_t i) {
+        return checkSphereSphereCollision(missiles[q], spheres[i]);
+    });
+
+    // No raio, a distância de cada esfera atingida também deve ser a mesma
+    // (a menos de arredondamento)
+    std::vector<float> distances(n);
+    CheckBatch("ray_sphere_batch", n, [&](size_t q, unsigned int* hits) {
+        return checkRaySphereBatch(rays[q], entities.x.data(), entities.y.data(), entities.z.data(),
+                                   AIRCRAFT_SPHERE_RADIUS, n, hits, distances.data());
+    }, [&](size_t q, size_t i) {
+        float t;
+        bool hit = checkRaySphereCollision(rays[q], spheres[i], t);
+        return hit && std::fabs(distances[i] - t) <= 1e-4f * std::max(t, 1.0f);
+    });
+
+    CheckBatch("cylinder_sphere_batch", n, [&](size_t q, unsigned int* hits) {
+        return checkCylinderSphereBatch(missiles[q], entities.x.data(), entities.y.data(), entities.z.data(),
+                                        ASTEROID_CYLINDER_RADIUS, ASTEROID_CYLINDER_HEIGHT, n, hits);
+    }, [&](size_t q, size_t i) {
+        return checkCylinderSphereCollision(cylinders[i], missiles[q]);
+    });
+}
+
+// Grade sobre a esfera (inimigos) e BVH (asteroides), como nas colisões da
+// simulação: montagem e consultas das esferas dos mísseis, com o teste exato
+// em cada candidato
+static void MeasureBroadphase(size_t n, const Shell& entities, const Shell& queries)
+{
+    int build_runs = Runs((double)n * 20.0);
+
+    SphereGrid grid;
+    SphereGrid_Init(grid, moon_position, 16);
+    double ms = TimeMs(build_runs, [&]() {
+        SphereGrid_Build(grid, entities.x.data(), entities.y.data(), entities.z.data(), n);
+    });
+    AddResult("broad", "spheregrid_build", n, build_runs, (double)n, -1.0, 0.0, ms);
+
+    float reach = missileRadius + AIRCRAFT_SPHERE_RADIUS;
+    size_t pairs = 0, hits = 0;
+    int query_runs = Runs((double)numQueries * 200.0);
+    ms = TimeMs(query_runs, [&]() {
+        pairs = hits = 0;
+        for (size_t q = 0; q < numQueries; ++q)
+        {
+            BoundingSphere missile = { queries.position(q), missileRadius };
+            SphereGrid_Query(grid, missile.center, reach, [&](unsigned int k) {
+                BoundingSphere enemy = { entities.position(grid.items[k]), AIRCRAFT_SPHERE_RADIUS };
+                ++pairs;
+                hits += checkSphereSphereCollision(missile, enemy) ? 1 : 0;
+            });
+        }
+    });
+    AddResult("broad", "spheregrid_query", n, query_runs, (double)numQueries, (double)pairs, (double)hits, ms);
+
+    std::vector<BvhBox> boxes(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        float c[3] = { entities.x[i], entities.y[i], entities.z[i] };
+        float half[3] = { ASTEROID_CYLINDER_RADIUS, ASTEROID_CYLINDER_HEIGHT / 2.0f, ASTEROID_CYLINDER_RADIUS };
+        for (int a = 0; a < 3; ++a)
+        {
+            boxes[i].min[a] = c[a] - half[a];
+            boxes[i].max[a] = c[a] + half[a];
+        }
+    }
+
+    Bvh bvh;
+    build_runs = Runs((double)n * 200.0);
+    ms = TimeMs(build_runs, [&]() { Bvh_Build(bvh, boxes.data(), n); });
+    AddResult("broad", "bvh_build", n, build_runs, (double)n, -1.0, 0.0, ms);
+
+    ms = TimeMs(query_runs, [&]() {
+        pairs = hits = 0;
+        for (size_t q = 0; q < numQueries; ++q)
+        {
+            BoundingSphere missile = { queries.position(q), missileRadius };
+            BvhBox box;
+            for (int a = 0; a < 3; ++a)
+            {
+                box.min[a] = missile.center[a] - missileRadius;
+                box.max[a] = missile.center[a] + missileRadius;
+            }
+            Bvh_QueryBox(bvh, box, [&](unsigned int i) {
+                ++pairs;
+                hits += checkCylinderSphereCollision(getAsteroidBoundingCylinder(entities.position(i)), missile) ? 1 : 0;
+            });
+        }
+    });
+    AddResult("broad", "bvh_query", n, query_runs, (double)numQueries, (double)pairs, (double)hits, ms);
+}
+
+// Cena da passada de colisões e das consultas: N inimigos, N/2 mísseis (um
+// terço deles dos inimigos) e N/4 asteroides, com a nave no meio deles
+static void MakeScene(GameState& scene, size_t n, const Shell& entities)
+{
+    Shell missiles, asteroids;
+    size_t num_missiles = std::max(n / 2, (size_t)1);
+    size_t num_asteroids = std::max(n / 4, (size_t)1);
+    MakeShell(missiles, num_missiles, 11u, missileStep);
+    MakeShell(asteroids, num_asteroids, 13u, 0.0f);
+
+    scene.missiles.reserve(num_missiles);
+    Sim_Reset(scene, 1);
+    scene.aircraftLife = 1000000000;
+
+    scene.enemies.clear();
+    for (size_t i = 0; i < n; ++i)
+    {
+        scene.enemies.push_back(entities.position(i), entities.forward[i]);
+        scene.enemies.prev_x[i] = entities.prev_x[i];
+        scene.enemies.prev_y[i] = entities.prev_y[i];
+        scene.enemies.prev_z[i] = entities.prev_z[i];
+    }
+    scene.randomAsteroids.clear();
+    for (size_t i = 0; i < num_asteroids; ++i)
+        scene.randomAsteroids.push_back(asteroids.position(i));
+
+    // Uma passada sem mísseis e com a nave longe monta a BVH dos asteroides
+    // sem destruir nada, para que as passadas medidas não a remontem
+    scene.aircraftPosition = scene.aircraftPositionPrev = glm::vec4(0.0f, 0.0f, 100.0f, 1.0f);
+    Sim_ProcessCollisions(scene);
+
+    scene.aircraftPosition = glm::vec4(0.0f, 0.0f, orbitDistance, 1.0f);
+    scene.aircraftPositionPrev = scene.aircraftPosition - 0.1f * scene.aircraftForward;
+    for (size_t i = 0; i < num_missiles; ++i)
+    {
+        MissileHandle handle = scene.missiles.spawn(missiles.position(i), missiles.forward[i], (unsigned char)(i % 3 == 0));
+        size_t k = scene.missiles.index(handle);
+        scene.missiles.prev_x[k] = missiles.prev_x[i];
+        scene.missiles.prev_y[k] = missiles.prev_y[i];
+        scene.missiles.prev_z[k] = missiles.prev_z[i];
+    }
+}
+
+static size_t SceneEntities(const GameState& scene)
+{
+    return scene.enemies.size() + scene.randomAsteroids.size() + scene.missiles.size();
+}
+
+// Passada completa de colisões na cena
+static void MeasurePass(size_t n, const GameState& base)
+{
+    static GameState state;
+
+    // Cada passada parte de uma cópia do estado (fora da medição), porque as
+    // colisões destroem entidades
+    int runs = std::min(Runs((double)SceneEntities(base) * 40.0), 1000);
+    double ms = 0.0;
+    size_t contacts = 0;
+    for (int r = 0; r < runs; ++r)
+    {
+        state = base;
+        ms += TimeMs(1, [&]() { Sim_ProcessCollisions(state); });
+        contacts = state.collisionEvents.size();
+    }
+    AddResult("passada", "process_collisions", n, runs, 1.0, -1.0, (double)contacts, ms);
+}
+
+// Raio-esfera das consultas: distância 0 com a origem dentro da esfera
+static bool LoopRaySphere(const Ray& ray, const BoundingSphere& sphere, float max_distance, float& t)
+{
+    if (distanceSq(ray.origin, sphere.center) <= sphere.radius * sphere.radius)
+    {
+        t = 0.0f;
+        return true;
+    }
+    return checkRaySphereCollision(ray, sphere, t) && t <= max_distance;
+}
+
+static void AddHit(std::vector<SceneQueryHit>& hits, unsigned int category, size_t index, float distance)
+{
+    SceneQueryHit hit = { category, (int)index, distance };
+    hits.push_back(hit);
+}
+
+// Ordem dos alvos devolvidos por SceneQuery_RaycastAll()
+static bool HitBefore(const SceneQueryHit& a, const SceneQueryHit& b)
+{
+    if (a.distance != b.distance)
+        return a.distance < b.distance;
+    if (a.category != b.category)
+        return a.category < b.category;
+    return a.index < b.index;
+}
+
+// SceneQuery_RaycastAll() com um laço sobre cada vetor do estado, com os
+// volumes descritos em "scenequery.h" (a cena não tem volumes ajustados às
+// malhas)
+static void LoopRaycastAll(const GameState& state, const Ray& ray, float max_distance,
+                           std::vector<SceneQueryHit>& hits)
+{
+    hits.clear();
+    float t;
+
+    BoundingSphere aircraft = { state.aircraftPosition, AIRCRAFT_SPHERE_RADIUS };
+    if (LoopRaySphere(ray, aircraft, max_distance, t))
+        AddHit(hits, QUERY_AIRCRAFT, 0, t);
+
+    for (size_t i = 0; i < state.enemies.size(); ++i)
+    {
+        BoundingSphere enemy = { state.enemies.position(i), AIRCRAFT_SPHERE_RADIUS };
+        if (LoopRaySphere(ray, enemy, max_distance, t))
+            AddHit(hits, QUERY_ENEMY, i, t);
+    }
+
+    for (size_t i = 0; i < state.randomAsteroids.size(); ++i)
+    {
+        BoundingOBB box;
+        box.center = state.randomAsteroids.position(i);
+        const float half[3] = { ASTEROID_CYLINDER_RADIUS, ASTEROID_CYLINDER_HEIGHT / 2.0f, ASTEROID_CYLINDER_RADIUS };
+        for (int a = 0; a < 3; ++a)
+        {
+            box.axis[a] = glm::vec4(a == 0, a == 1, a == 2, 0.0f);
+            box.halfSize[a] = half[a];
+        }
+        if (checkRayOBBCollision(ray, box, t) && t <= max_distance)
+            AddHit(hits, QUERY_ASTEROID, i, t);
+    }
+
+    for (size_t i = 0; i < state.checkpoints.size(); ++i)
+        if (LoopRaySphere(ray, getCheckpointBoundingSphere(state.checkpoints[i]), max_distance, t))
+            AddHit(hits, QUERY_CHECKPOINT, i, t);
+
+    for (size_t i = 0; i < state.missiles.size(); ++i)
+    {
+        BoundingSphere missile = { state.missiles.position(i), missileRadius };
+        if (LoopRaySphere(ray, missile, max_distance, t))
+            AddHit(hits, QUERY_MISSILE, i, t);
+    }
+
+    std::sort(hits.begin(), hits.end(), HitBefore);
+}
+
+// SceneQuery_OverlapSphere() com um laço sobre cada vetor do estado
+static void LoopOverlapSphere(const GameState& state, const BoundingSphere& sphere, std::vector<SceneQueryHit>& hits)
+{
+    hits.clear();
+
+    BoundingSphere aircraft = { state.aircraftPosition, AIRCRAFT_SPHERE_RADIUS };
+    if (checkSphereSphereCollision(aircraft, sphere))
+        AddHit(hits, QUERY_AIRCRAFT, 0, 0.0f);
+
+    for (size_t i = 0; i < state.enemies.size(); ++i)
+    {
+        BoundingSphere enemy = { state.enemies.position(i), AIRCRAFT_SPHERE_RADIUS };
+        if (checkSphereSphereCollision(enemy, sphere))
+            AddHit(hits, QUERY_ENEMY, i, 0.0f);
+    }
+
+    for (size_t i = 0; i < state.randomAsteroids.size(); ++i)
+        if (checkCylinderSphereCollision(getAsteroidBoundingCylinder(state.randomAsteroids.position(i)), sphere))
+            AddHit(hits, QUERY_ASTEROID, i, 0.0f);
+
+    for (size_t i = 0; i < state.checkpoints.size(); ++i)
+        if (checkSphereSphereCollision(getCheckpointBoundingSphere(state.checkpoints[i]), sphere))
+            AddHit(hits, QUERY_CHECKPOINT, i, 0.0f);
+
+    for (size_t i = 0; i < state.missiles.size(); ++i)
+    {
+        BoundingSphere missile = { state.missiles.position(i), missileRadius };
+        if (checkSphereSphereCollision(missile, sphere))
+            AddHit(hits, QUERY_MISSILE, i, 0.0f);
+    }
+}
+
+static bool SameHits(const SceneQueryHit* a, const SceneQueryHit* b, size_t n)
+{
+    for (size_t k = 0; k < n; ++k)
+        if (a[k].category != b[k].category || a[k].index != b[k].index || a[k].distance != b[k].distance)
+            return false;
+    return true;
+}
+
+// Consultas da cena (mira ao longo da direção de cada consulta e esfera em
+// volta dela), medidas e conferidas com os laços sobre todas as entidades
+static void MeasureQueries(size_t n, const GameState& scene, const Shell& queries)
+{
+    SceneQuery query;
+    SceneQuery_Update(query, scene);
+
+    std::vector<Ray> rays(numQueries);
+    std::vector<BoundingSphere> spheres(numQueries);
+    for (size_t q = 0; q < numQueries; ++q)
+    {
+        rays[q].origin = queries.prevPosition(q);
+        rays[q].direction = queries.forward[q];
+        spheres[q].center = queries.position(q);
+        spheres[q].radius = querySphereRadius;
+    }
+
+    std::vector<SceneQueryHit> closest(numQueries), loop_closest(numQueries);
+    std::vector<std::vector<SceneQueryHit> > all(numQueries), loop_all(numQueries);
+    std::vector<std::vector<SceneQueryHit> > overlap(numQueries), loop_overlap(numQueries);
+
+    int query_runs = Runs((double)numQueries * 200.0);
+    int loop_runs = Runs((double)numQueries * SceneEntities(scene));
+    size_t hits = 0;
+
+    double ms = TimeMs(query_runs, [&]() {
+        hits = 0;
+        for (size_t q = 0; q < numQueries; ++q)
+            hits += SceneQuery_RaycastClosest(query, rays[q], queryRayDistance, QUERY_ALL, closest[q]) ? 1 : 0;
+    });
+    AddResult("consulta", "raycast_closest", n, query_runs, (double)numQueries, -1.0, (double)hits, ms);
+
+    ms = TimeMs(query_runs, [&]() {
+        hits = 0;
+        for (size_t q = 0; q < numQueries; ++q)
+            hits += SceneQuery_RaycastAll(query, rays[q], queryRayDistance, QUERY_ALL, all[q]);
+    });
+    AddResult("consulta", "raycast_all", n, query_runs, (double)numQueries, -1.0, (double)hits, ms);
+
+    // O laço encontra todos os alvos; o primeiro deles é o de RaycastClosest()
+    ms = TimeMs(loop_runs, [&]() {
+        hits = 0;
+        for (size_t q = 0; q < numQueries; ++q)
+        {
+            LoopRaycastAll(scene, rays[q], queryRayDistance, loop_all[q]);
+            hits += loop_all[q].size();
+        }
+    });
+    AddResult("consulta", "raycast_all_loop", n, loop_runs, (double)numQueries, -1.0, (double)hits, ms);
+
+    for (size_t q = 0; q < numQueries; ++q)
+    {
+        SceneQueryHit none = { 0, -1, queryRayDistance };
+        loop_closest[q] = loop_all[q].empty() ? none : loop_all[q][0];
+    }
+
+    ms = TimeMs(query_runs, [&]() {
+        hits = 0;
+        for (size_t q = 0; q < numQueries; ++q)
+            hits += SceneQuery_OverlapSphere(query, spheres[q], QUERY_ALL, overlap[q]);
+    });
+    AddResult("consulta", "overlap_sphere", n, query_runs, (double)numQueries, -1.0, (double)hits, ms);
+
+    ms = TimeMs(loop_runs, [&]() {
+        hits = 0;
+        for (size_t q = 0; q < numQueries; ++q)
+        {
+            LoopOverlapSphere(scene, spheres[q], loop_overlap[q]);
+            hits += loop_overlap[q].size();
+        }
+    });
+    AddResult("consulta", "overlap_sphere_loop", n, loop_runs, (double)numQueries, -1.0, (double)hits, ms);
+
+    // Cada consulta deve devolver os mesmos alvos, na mesma ordem e com as
+    // mesmas distâncias, que os laços
+    size_t closest_mismatches = 0, all_mismatches = 0, overlap_mismatches = 0;
+    for (size_t q = 0; q < numQueries; ++q)
+    {
+        closest_mismatches += SameHits(&closest[q], &loop_closest[q], 1) ? 0 : 1;
+        all_mismatches += (all[q].size() == loop_all[q].size()
+                           && SameHits(all[q].data(), loop_all[q].data(), all[q].size())) ? 0 : 1;
+        overlap_mismatches += (overlap[q].size() == loop_overlap[q].size()
+                               && SameHits(overlap[q].data(), loop_overlap[q].data(), overlap[q].size())) ? 0 : 1;
+    }
+
+    Check checks[] = {
+        { "consulta", "raycast_closest", n, (double)numQueries, closest_mismatches },
+        { "consulta", "raycast_all", n, (double)numQueries, all_mismatches },
+        { "consulta", "overlap_sphere", n, (double)numQueries, overlap_mismatches },
+    };
+    g_Checks.insert(g_Checks.end(), checks, checks + sizeof(checks) / sizeof(checks[0]));
+}
+
+static void Run(size_t n)
+{
+    Shell entities, queries;
+    MakeShell(entities, n, 7u, enemyStep);
+    MakeShell(queries, numQueries, 5u, missileStep);
+
+    static GameState scene;
+    MakeScene(scene, n, entities);
+
+    MeasureTests(n, entities, queries);
+    MeasureBroadphase(n, entities, queries);
+    MeasurePass(n, scene);
+    MeasureQueries(n, scene, queries);
+}
+
+static double NsPerTest(const Result& result)
+{
+    return result.ms * 1e6 / (result.tests * result.runs);
+}
+
+static void PrintTable()
+{
+    size_t n = (size_t)-1;
+    for (size_t k = 0; k < g_Results.size(); ++k)
+    {
+        const Result& r = g_Results[k];
+        if (r.n != n)
+        {
+            n = r.n;
+            printf("entidades: %zu\n", n);
+        }
+
+        char pairs[32] = "-";
+        if (r.pairs >= 0.0)
+            snprintf(pairs, sizeof(pairs), "%.0f", r.pairs);
+
+        printf("  %-8s %-22s testes: %10.0f  pares: %10s  contatos: %8.0f  %12.2f ns/teste\n",
+               r.group, r.name, r.tests, pairs, r.hits, NsPerTest(r));
+    }
+
+    printf("conferências (testes em lote com %s):\n", collisionBatchPath());
+    for (size_t k = 0; k < g_Checks.size(); ++k)
+    {
+        const Check& c = g_Checks[k];
+        printf("  %-8s %-22s entidades: %6zu  testes: %10.0f  diferenças: %zu\n",
+               c.group, c.name, c.n, c.tests, c.mismatches);
+    }
+}
+
+static void PrintJson()
+{
+    printf("{\n  \"benchmark\": \"collisions\",\n  \"queries\": %zu,\n  \"batch_path\": \"%s\",\n  \"results\": [\n",
+           numQueries, collisionBatchPath());
+    for (size_t k = 0; k < g_Results.size(); ++k)
+    {
+        const Result& r = g_Results[k];
+        printf("    {\"group\": \"%s\", \"name\": \"%s\", \"n\": %zu, \"runs\": %d, \"tests\": %.0f, ",
+               r.group, r.name, r.n, r.runs, r.tests);
+        if (r.pairs >= 0.0)
+            printf("\"pairs\": %.0f, ", r.pairs);
+        else
+            printf("\"pairs\": null, ");
+        printf("\"hits\": %.0f, \"ns_per_test\": %.3f}%s\n", r.hits, NsPerTest(r), k + 1 < g_Results.size() ? "," : "");
+    }
+    printf("  ],\n  \"checks\": [\n");
+    for (size_t k = 0; k < g_Checks.size(); ++k)
+    {
+        const Check& c = g_Checks[k];
+        printf("    {\"group\": \"%s\", \"name\": \"%s\", \"n\": %zu, \"tests\": %.0f, \"mismatches\": %zu}%s\n",
+               c.group, c.name, c.n, c.tests, c.mismatches, k + 1 < g_Checks.size() ? "," : "");
+    }
+    printf("  ]\n}\n");
+}
+
+static size_t Mismatches()
+{
+    size_t total = 0;
+    for (size_t k = 0; k < g_Checks.size(); ++k)
+        total += g_Checks[k].mismatches;
+    return total;
+}
+
+// Lê o inteiro "text" em "value". Devolve false se o texto não for um número
+// positivo.
+static bool ParseCount(const char* text, long& value)
+{
+    char* end;
+    value = strtol(text, &end, 10);
+    return end != text && *end == '\0' && value > 0;
+}
+
+int main(int argc, char* argv[])
+{
+    bool json = false;
+    size_t n = 0;
+    for (int i = 1; i < argc; ++i)
+    {
+        long count;
+        if (strcmp(argv[i], "--json") == 0)
+        {
+            json = true;
+        }
+        else if (ParseCount(argv[i], count))
+        {
+            n = (size_t)count;
+        }
+        else
+        {
+            fprintf(stderr, "Uso: bench_collisions [--json] [entidades]\n"
+                            "     entidades > 0\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (n > 0)
+    {
+        Run(n);
+    }
+    else
+    {
+        const size_t sizes[] = { 10, 100, 1000, 10000, 100000 };
+        for (size_t k = 0; k < sizeof(sizes) / sizeof(sizes[0]); ++k)
+            Run(sizes[k]);
+    }
+
+    if (json)
+        PrintJson();
+    else
+        PrintTable();
+
+    if (Mismatches() > 0)
+    {
+        fprintf(stderr, "bench_collisions: %zu diferenças nas conferências\n", Mismatches());
+        return EXIT_FAILURE;
+    }
+    return 0;
+}
@@ -0,0 +1,169 @@
+// Mede a vazão do steering dos inimigos (perseguição da nave), em inimigos
+// por milissegundo, comparando Orbit_Steer() com a versão escalar anterior
+// (acos e Matrix_Rotate por inimigo).
+//
+// Uso: bench_steering [inimigos] [passos]
+//      sem argumentos, mede 3, 64, 1024 e 16384 inimigos.
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <chrono>
+#include <vector>
+
+#include "orbitmotion.h"
+#include "matrices.h"
+
+static const glm::vec4 center(0.0f, 0.0f, 0.0f, 1.0f);
+static const float radius = 16.0f;
+static const float max_turn = 2.0f / 60.0f; // turnRate * delta_t
+
+struct Enemies
+{
+    std::vector<float> x, y, z, fx, fy, fz;
+};
+
+// Inimigos em posições pseudo-aleatórias na órbita, com direções tangentes
+static void MakeEnemies(Enemies& e, size_t n)
+{
+    e.x.resize(n); e.y.resize(n); e.z.resize(n);
+    e.fx.resize(n); e.fy.resize(n); e.fz.resize(n);
+
+    unsigned int rng = 7u;
+    for (size_t i = 0; i < n; ++i)
+    {
+        float v[6];
+        for (int k = 0; k < 6; ++k)
+        {
+            rng = rng * 1664525u + 1013904223u;
+            v[k] = (float)(rng >> 8) / 8388608.0f - 1.0f;
+        }
+
+        glm::vec4 p = glm::vec4(v[0], v[1], v[2], 0.0f);
+        p = p / norm(p);
+        glm::vec4 f = glm::vec4(v[3], v[4], v[5], 0.0f);
+        f = f - dotproduct(f, p) * p;
+        f = f / norm(f);
+
+        e.x[i] = radius * p.x; e.y[i] = radius * p.y; e.z[i] = radius * p.z;
+        e.fx[i] = f.x; e.fy[i] = f.y; e.fz[i] = f.z;
+    }
+}
+
+// Steering escalar anterior, de moveEnemies()
+static void SteerReference(Enemies& e, const glm::vec4& target)
+{
+    for (size_t i = 0; i < e.x.size(); ++i)
+    {
+        glm::vec4 pos = glm::vec4(e.x[i], e.y[i], e.z[i], 1.0f);
+        glm::vec4 forward = glm::vec4(e.fx[i], e.fy[i], e.fz[i], 0.0f);
+        glm::vec4 up = (pos - center) / norm(pos - center);
+
+        forward = forward - dotproduct(forward, up) * up;
+        forward = forward / norm(forward);
+
+        glm::vec4 to_target = target - pos;
+        to_target.w = 0.0f;
+        glm::vec4 desired = to_target - dotproduct(to_target, up) * up;
+        desired = desired / norm(desired);
+
+        glm::vec4 axis = crossproduct(forward, desired);
+        float dot_value = dotproduct(forward, desired);
+        if (dot_value > 1.0f) dot_value = 1.0f;
+        if (dot_value < -1.0f) dot_value = -1.0f;
+
+        float angle = std::acos(dot_value);
+        if (angle > max_turn)
+            angle = max_turn;
+
+        forward = Matrix_Rotate(angle, axis) * forward;
+        forward = forward / norm(forward);
+
+        e.fx[i] = forward.x; e.fy[i] = forward.y; e.fz[i] = forward.z;
+    }
+}
+
+static void SteerKernel(Enemies& e, const glm::vec4& target)
+{
+    Orbit_Steer(e.x.data(), e.y.data(), e.z.data(), e.fx.data(), e.fy.data(), e.fz.data(), e.x.size(),
+                target, center, max_turn);
+}
+
+// Alvo que se move pela órbita a cada passo, como a nave
+static glm::vec4 Target(int step)
+{
+    float a = 0.01f * step;
+    return glm::vec4(radius * std::cos(a), radius * std::sin(a) * 0.6f, radius * std::sin(a) * 0.8f, 1.0f);
+}
+
+// Inimigos por milissegundo de "steer" em "steps" passos
+template <typename Steer>
+static double Measure(Steer steer, size_t n, int steps, Enemies& e)
+{
+    MakeEnemies(e, n);
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int step = 0; step < steps; ++step)
+        steer(e, Target(step));
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+    double ms = std::chrono::duration<double, std::milli>(end - start).count();
+    return (double)n * steps / ms;
+}
+
+static void Run(size_t n, int steps)
+{
+    Enemies reference, kernel;
+    double reference_rate = Measure(SteerReference, n, steps, reference);
+    double kernel_rate = Measure(SteerKernel, n, steps, kernel);
+
+    // Maior diferença de direção entre as duas versões após um passo
+    MakeEnemies(reference, n);
+    MakeEnemies(kernel, n);
+    SteerReference(reference, Target(0));
+    SteerKernel(kernel, Target(0));
+    float max_error = 0.0f;
+    for (size_t i = 0; i < n; ++i)
+    {
+        float error = std::fabs(reference.fx[i] - kernel.fx[i]) + std::fabs(reference.fy[i] - kernel.fy[i])
+                    + std::fabs(reference.fz[i] - kernel.fz[i]);
+        if (error > max_error)
+            max_error = error;
+    }
+
+    printf("inimigos: %6zu  escalar: %9.0f inimigos/ms  kernel: %9.0f inimigos/ms  (%.1fx)  diferença máx.: %.2g\n",
+           n, reference_rate, kernel_rate, kernel_rate / reference_rate, max_error);
+}
+
+// Lê o inteiro "text" em "value". Devolve false se o texto não for um número
+// positivo.
+static bool ParseCount(const char* text, long& value)
+{
+    char* end;
+    value = strtol(text, &end, 10);
+    return end != text && *end == '\0' && value > 0;
+}
+
+int main(int argc, char* argv[])
+{
+    long count = 0, steps = 0;
+    if ((argc > 1 && !ParseCount(argv[1], count))
+        || (argc > 2 && !ParseCount(argv[2], steps)))
+    {
+        fprintf(stderr, "Uso: bench_steering [inimigos] [passos]\n"
+                        "     inimigos e passos > 0\n");
+        return EXIT_FAILURE;
+    }
+
+    if (argc > 1)
+    {
+        size_t n = (size_t)count;
+        Run(n, steps > 0 ? (int)steps : (int)(2000000 / n + 1));
+        return 0;
+    }
+
+    const size_t sizes[] = { 3, 64, 1024, 16384 };
+    for (size_t k = 0; k < sizeof(sizes) / sizeof(sizes[0]); ++k)
+        Run(sizes[k], steps > 0 ? (int)steps : (int)(2000000 / sizes[k] + 1));
+
+    return 0;
+}
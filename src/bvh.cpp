@@ -0,0 +1,156 @@
+// Hierarquia de volumes delimitadores. Veja "bvh.h".
+#include <algorithm>
+
+#include "bvh.h"
+
+static BvhBox Bvh_EmptyBox()
+{
+    BvhBox box;
+    for (int a = 0; a < 3; ++a) {
+        box.min[a] = 3.4e38f;
+        box.max[a] = -3.4e38f;
+    }
+    return box;
+}
+
+static void Bvh_Grow(BvhBox& box, const BvhBox& other)
+{
+    for (int a = 0; a < 3; ++a) {
+        box.min[a] = std::min(box.min[a], other.min[a]);
+        box.max[a] = std::max(box.max[a], other.max[a]);
+    }
+}
+
+// Ordena os itens de um intervalo pelo centro da caixa em um eixo
+struct BvhCenterLess {
+    const BvhBox* boxes;
+    int axis;
+    bool operator()(unsigned int a, unsigned int b) const {
+        return boxes[a].min[axis] + boxes[a].max[axis] < boxes[b].min[axis] + boxes[b].max[axis];
+    }
+};
+
+// Preenche o nó "n" com os itens [first, first + count) de bvh.items,
+// dividindo-os pela mediana do eixo em que os centros estão mais espalhados
+static void Bvh_BuildNode(Bvh& bvh, const BvhBox* boxes, int n, unsigned int first, unsigned int count)
+{
+    BvhBox box = Bvh_EmptyBox();
+    BvhBox centers = Bvh_EmptyBox();
+    for (unsigned int k = first; k < first + count; ++k) {
+        const BvhBox& item = boxes[bvh.items[k]];
+        Bvh_Grow(box, item);
+        BvhBox center;
+        for (int a = 0; a < 3; ++a)
+            center.min[a] = center.max[a] = 0.5f * (item.min[a] + item.max[a]);
+        Bvh_Grow(centers, center);
+    }
+
+    bvh.nodes[n].box = box;
+    bvh.nodes[n].alive = count;
+
+    if (count <= BVH_LEAF_SIZE) {
+        bvh.nodes[n].left = -1;
+        bvh.nodes[n].first = first;
+        bvh.nodes[n].count = count;
+        return;
+    }
+
+    int axis = 0;
+    for (int a = 1; a < 3; ++a)
+        if (centers.max[a] - centers.min[a] > centers.max[axis] - centers.min[axis])
+            axis = a;
+
+    unsigned int half = count / 2;
+    BvhCenterLess less = { boxes, axis };
+    std::nth_element(bvh.items.begin() + first, bvh.items.begin() + first + half,
+                     bvh.items.begin() + first + count, less);
+
+    int left = (int)bvh.nodes.size();
+    BvhNode child;
+    child.parent = n;
+    child.left = -1;
+    child.first = child.count = child.alive = 0;
+    bvh.nodes.push_back(child);
+    bvh.nodes.push_back(child);
+
+    bvh.nodes[n].left = left;
+    bvh.nodes[n].first = first;
+    bvh.nodes[n].count = count;
+
+    Bvh_BuildNode(bvh, boxes, left, first, half);
+    Bvh_BuildNode(bvh, boxes, left + 1, first + half, count - half);
+}
+
+void Bvh_Build(Bvh& bvh, const BvhBox* boxes, size_t n)
+{
+    bvh.nodes.clear();
+    bvh.items.resize(n);
+    for (size_t i = 0; i < n; ++i)
+        bvh.items[i] = (unsigned int)i;
+
+    bvh.itemBoxes.resize(n);
+    bvh.itemAlive.assign(n, 1);
+    bvh.itemSlot.resize(n);
+    bvh.itemLeaf.resize(n);
+
+    if (n == 0)
+        return;
+
+    bvh.nodes.reserve(n + 1);
+    BvhNode root;
+    root.parent = -1;
+    root.left = -1;
+    root.first = root.count = root.alive = 0;
+    bvh.nodes.push_back(root);
+    Bvh_BuildNode(bvh, boxes, 0, 0, (unsigned int)n);
+
+    // Caixas na ordem das folhas, e a posição e a folha de cada item
+    for (size_t k = 0; k < n; ++k) {
+        bvh.itemBoxes[k] = boxes[bvh.items[k]];
+        bvh.itemSlot[bvh.items[k]] = (int)k;
+    }
+    for (size_t node = 0; node < bvh.nodes.size(); ++node) {
+        const BvhNode& leaf = bvh.nodes[node];
+        if (leaf.left >= 0)
+            continue;
+        for (unsigned int k = leaf.first; k < leaf.first + leaf.count; ++k)
+            bvh.itemLeaf[bvh.items[k]] = (int)node;
+    }
+}
+
+void Bvh_RenumberItems(Bvh& bvh, std::vector<unsigned int>& order)
+{
+    order = bvh.items;
+
+    std::vector<int> leaf(bvh.itemLeaf);
+    for (size_t k = 0; k < order.size(); ++k) {
+        bvh.items[k] = (unsigned int)k;
+        bvh.itemSlot[k] = (int)k;
+        bvh.itemLeaf[k] = leaf[order[k]];
+    }
+}
+
+bool Bvh_Remove(Bvh& bvh, unsigned int item)
+{
+    if (item >= bvh.itemSlot.size())
+        return false;
+
+    int slot = bvh.itemSlot[item];
+    if (!bvh.itemAlive[slot])
+        return false;
+
+    bvh.itemAlive[slot] = 0;
+    for (int n = bvh.itemLeaf[item]; n >= 0; n = bvh.nodes[n].parent)
+        --bvh.nodes[n].alive;
+    return true;
+}
+
+size_t Bvh_ItemCount(const Bvh& bvh)
+{
+    return bvh.items.size();
+}
+
+size_t Bvh_AliveCount(const Bvh& bvh)
+{
+    return bvh.nodes.empty() ? 0 : bvh.nodes[0].alive;
+}
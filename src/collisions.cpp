@@ -7,6 +7,16 @@
 #include <limits>
 #include <cmath> 
 
+#if defined(__AVX__)
+#define COLLISIONS_USE_AVX
+#include <immintrin.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define COLLISIONS_USE_SSE
+#include <emmintrin.h>
+#endif
+
 // Fonte: Gemini
 const float MOON_RADIUS = 16.0f;
 const float AIRCRAFT_SPHERE_RADIUS = 0.3f; 
@@ -14,6 +24,10 @@ const float CHECKPOINT_RADIUS = 1.5f;
 const float ASTEROID_CYLINDER_RADIUS = 0.5f; 
 const float ASTEROID_CYLINDER_HEIGHT = 1.0f; 
 
+// Raio da malha da lua desenhada (sphere.obj tem raio ~58.4 e é escalada por
+// 15/60). Usamos um valor um pouco menor, para que a oclusão seja conservadora.
+const float MOON_OCCLUDER_RADIUS = 14.5f;
+
 /**
  * Calcula a distância euclidiana ao quadrado (evita raiz quadrada).
  */
@@ -122,6 +136,830 @@ bool checkCylinderSphereCollision(const BoundingCylinder& cylinder, const Boundi
 }
 
 
+/**
+ * Teste de OCLUSÃO de uma esfera por outra esfera (Lua vs. Entidade)
+ */
+bool checkSphereOccludedBySphere(const glm::vec4& eye, const BoundingSphere& occluder, const BoundingSphere& sphere) {
+    glm::vec4 toOccluder = occluder.center - eye;
+    toOccluder.w = 0.0f;
+    glm::vec4 toSphere = sphere.center - eye;
+    toSphere.w = 0.0f;
+
+    float occluderDistSq = dot(toOccluder, toOccluder);
+    float sphereDistSq = dot(toSphere, toSphere);
+
+    // Observador dentro de alguma das esferas: nada pode ser considerado escondido
+    if (occluderDistSq <= occluder.radius * occluder.radius ||
+        sphereDistSq <= sphere.radius * sphere.radius) {
+        return false;
+    }
+
+    float occluderDist = std::sqrt(occluderDistSq);
+    float sphereDist = std::sqrt(sphereDistSq);
+
+    // A silhueta do oclusor está a uma distância sqrt(d^2 - R^2) do
+    // observador. Todo ponto dentro do cone tangente e além dessa distância
+    // está atrás da superfície do oclusor.
+    float silhouetteDist = std::sqrt(occluderDistSq - occluder.radius * occluder.radius);
+    if (sphereDist - sphere.radius < silhouetteDist) {
+        return false;
+    }
+
+    // Semi-ângulos dos cones que envolvem cada esfera e ângulo entre os centros
+    float occluderAngle = std::asin(occluder.radius / occluderDist);
+    float sphereAngle = std::asin(sphere.radius / sphereDist);
+
+    float cosBetween = dot(toOccluder, toSphere) / (occluderDist * sphereDist);
+    cosBetween = std::max(-1.0f, std::min(1.0f, cosBetween));
+    float angleBetween = std::acos(cosBetween);
+
+    // O cone da esfera precisa estar inteiramente contido no cone do oclusor
+    return angleBetween + sphereAngle <= occluderAngle;
+}
+
+
+/**
+ * Teste de Intersecção CÁPSULA-ESFERA
+ */
+bool checkCapsuleSphereCollision(const BoundingCapsule& capsule, const BoundingSphere& sphere) {
+    // Ponto do segmento a-b mais próximo do centro da esfera
+    glm::vec4 ab = capsule.b - capsule.a;
+    glm::vec4 ac = sphere.center - capsule.a;
+    ab.w = 0.0f;
+    ac.w = 0.0f;
+
+    float lengthSq = dot(ab, ab);
+    float t = 0.0f;
+    if (lengthSq > 0.0f) {
+        t = std::min(std::max(dot(ac, ab) / lengthSq, 0.0f), 1.0f);
+    }
+
+    glm::vec4 closest = capsule.a + t * ab;
+    float radiusSum = capsule.radius + sphere.radius;
+    return distanceSq(closest, sphere.center) <= radiusSum * radiusSum;
+}
+
+/**
+ * Teste de Intersecção CAIXA ORIENTADA-ESFERA
+ */
+bool checkOBBSphereCollision(const BoundingOBB& box, const BoundingSphere& sphere) {
+    // Distância do centro da esfera até a caixa, eixo por eixo, nas
+    // coordenadas da caixa
+    glm::vec4 d = sphere.center - box.center;
+    d.w = 0.0f;
+
+    float distSq = 0.0f;
+    for (int a = 0; a < 3; ++a) {
+        float coord = dot(d, box.axis[a]);
+        float excess = std::fabs(coord) - box.halfSize[a];
+        if (excess > 0.0f) {
+            distSq += excess * excess;
+        }
+    }
+
+    return distSq <= sphere.radius * sphere.radius;
+}
+
+
+/**
+ * Teste de Intersecção RAIO-CAIXA ORIENTADA
+ */
+bool checkRayOBBCollision(const Ray& ray, const BoundingOBB& box, float& t_out) {
+    // Teste das "placas": em cada eixo da caixa, o raio está entre os dois
+    // planos da caixa em um intervalo de t; a caixa é atingida se os três
+    // intervalos (e t >= 0) tiverem algum ponto em comum
+    glm::vec4 d = box.center - ray.origin;
+    d.w = 0.0f;
+
+    float tMin = 0.0f;
+    float tMax = std::numeric_limits<float>::max();
+
+    for (int a = 0; a < 3; ++a) {
+        float e = dot(box.axis[a], d);
+        float f = dot(box.axis[a], ray.direction);
+
+        if (std::fabs(f) < 1e-8f) {
+            // Raio paralelo às placas: precisa estar entre elas
+            if (std::fabs(e) > box.halfSize[a]) {
+                return false;
+            }
+            continue;
+        }
+
+        float t1 = (e - box.halfSize[a]) / f;
+        float t2 = (e + box.halfSize[a]) / f;
+        if (t1 > t2) {
+            std::swap(t1, t2);
+        }
+        tMin = std::max(tMin, t1);
+        tMax = std::min(tMax, t2);
+        if (tMin > tMax) {
+            return false;
+        }
+    }
+
+    t_out = tMin;
+    return true;
+}
+
+// Ponto do triângulo a-b-c mais próximo de p: um vértice, um ponto de uma
+// aresta ou um ponto do interior, conforme a região de Voronoi em que p está
+static glm::vec4 closestPointOnTriangle(const glm::vec4& p, const glm::vec4& a, const glm::vec4& b, const glm::vec4& c) {
+    glm::vec4 ab = b - a;
+    glm::vec4 ac = c - a;
+    glm::vec4 ap = p - a;
+    ab.w = ac.w = ap.w = 0.0f;
+
+    float d1 = dot(ab, ap);
+    float d2 = dot(ac, ap);
+    if (d1 <= 0.0f && d2 <= 0.0f)
+        return a;
+
+    glm::vec4 bp = p - b;
+    bp.w = 0.0f;
+    float d3 = dot(ab, bp);
+    float d4 = dot(ac, bp);
+    if (d3 >= 0.0f && d4 <= d3)
+        return b;
+
+    float vc = d1 * d4 - d3 * d2;
+    if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f)
+        return a + (d1 / (d1 - d3)) * ab;
+
+    glm::vec4 cp = p - c;
+    cp.w = 0.0f;
+    float d5 = dot(ab, cp);
+    float d6 = dot(ac, cp);
+    if (d6 >= 0.0f && d5 <= d6)
+        return c;
+
+    float vb = d5 * d2 - d1 * d6;
+    if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f)
+        return a + (d2 / (d2 - d6)) * ac;
+
+    float va = d3 * d6 - d5 * d4;
+    if (va <= 0.0f && d4 - d3 >= 0.0f && d5 - d6 >= 0.0f)
+        return b + ((d4 - d3) / ((d4 - d3) + (d5 - d6))) * (c - b);
+
+    float inv = 1.0f / (va + vb + vc);
+    return a + (vb * inv) * ab + (vc * inv) * ac;
+}
+
+/**
+ * Teste de Intersecção TRIÂNGULO-ESFERA
+ */
+bool checkTriangleSphereCollision(const glm::vec4& a, const glm::vec4& b, const glm::vec4& c,
+                                  const BoundingSphere& sphere) {
+    glm::vec4 closest = closestPointOnTriangle(sphere.center, a, b, c);
+    return distanceSq(closest, sphere.center) <= sphere.radius * sphere.radius;
+}
+
+/**
+ * Teste de Intersecção RAIO-TRIÂNGULO
+ */
+bool checkRayTriangleCollision(const Ray& ray, const glm::vec4& a, const glm::vec4& b, const glm::vec4& c,
+                               float& t_out) {
+    glm::vec3 direction(ray.direction);
+    glm::vec3 e1(b - a);
+    glm::vec3 e2(c - a);
+
+    // Determinante perto de zero: raio paralelo ao plano do triângulo
+    glm::vec3 p = glm::cross(direction, e2);
+    float det = glm::dot(e1, p);
+    if (std::fabs(det) < 1e-12f) {
+        return false;
+    }
+    float inv = 1.0f / det;
+
+    // Coordenadas baricêntricas (u, v) do ponto atingido
+    glm::vec3 s(ray.origin - a);
+    float u = glm::dot(s, p) * inv;
+    if (u < 0.0f || u > 1.0f) {
+        return false;
+    }
+
+    glm::vec3 q = glm::cross(s, e1);
+    float v = glm::dot(direction, q) * inv;
+    if (v < 0.0f || u + v > 1.0f) {
+        return false;
+    }
+
+    float t = glm::dot(e2, q) * inv;
+    if (t < 0.0f) {
+        return false;
+    }
+
+    t_out = t;
+    return true;
+}
+
+/**
+ * Teste Contínuo ESFERA-ESFERA (Míssil vs. Inimigo, Nave vs. Inimigo)
+ */
+bool checkSweptSphereSphereCollision(const BoundingSphere& a, const glm::vec4& a_end,
+                                     const BoundingSphere& b, const glm::vec4& b_end, float& t_out) {
+    // Movimento de "a" visto de "b": p(t) = p + t * d
+    glm::vec4 p = a.center - b.center;
+    glm::vec4 d = (a_end - a.center) - (b_end - b.center);
+    p.w = 0.0f;
+    d.w = 0.0f;
+
+    float radiusSum = a.radius + b.radius;
+
+    // |p + t d|^2 = r^2  =>  (d.d) t^2 + 2 (p.d) t + (p.p - r^2) = 0
+    float C = dot(p, p) - radiusSum * radiusSum;
+    if (C <= 0.0f) {
+        t_out = 0.0f; // Já se tocam no início do passo
+        return true;
+    }
+
+    float A = dot(d, d);
+    float B = dot(p, d);
+    if (A == 0.0f || B >= 0.0f) {
+        return false; // Parados uma em relação à outra, ou se afastando
+    }
+
+    float discriminant = B * B - A * C;
+    if (discriminant < 0.0f) {
+        return false;
+    }
+
+    float t = (-B - std::sqrt(discriminant)) / A;
+    if (t > 1.0f) {
+        return false;
+    }
+
+    t_out = t;
+    return true;
+}
+
+/**
+ * Teste Contínuo CILINDRO-ESFERA (Míssil vs. Asteroide, Nave vs. Asteroide)
+ */
+bool checkSweptCylinderSphereCollision(const BoundingCylinder& cylinder, const BoundingSphere& sphere,
+                                       const glm::vec4& sphere_end, float& t_out) {
+    // A esfera toca o cilindro quando o seu centro está dentro do cilindro de
+    // raio (raio + raio da esfera) e meia altura (altura / 2 + raio da esfera)
+    glm::vec4 p = sphere.center - cylinder.center;
+    glm::vec4 d = sphere_end - sphere.center;
+
+    float radialSum = cylinder.radius + sphere.radius;
+    float verticalSum = cylinder.height / 2.0f + sphere.radius;
+
+    // Intervalo [t_min, t_max] em que as duas condições valem
+    float t_min = 0.0f;
+    float t_max = 1.0f;
+
+    // Radial (plano XZ): (px + t dx)^2 + (pz + t dz)^2 <= r^2
+    float A = d.x * d.x + d.z * d.z;
+    float B = p.x * d.x + p.z * d.z;
+    float C = p.x * p.x + p.z * p.z - radialSum * radialSum;
+    if (A == 0.0f) {
+        if (C > 0.0f) {
+            return false;
+        }
+    } else {
+        float discriminant = B * B - A * C;
+        if (discriminant < 0.0f) {
+            return false;
+        }
+        float sqrtDiscriminant = std::sqrt(discriminant);
+        t_min = std::max(t_min, (-B - sqrtDiscriminant) / A);
+        t_max = std::min(t_max, (-B + sqrtDiscriminant) / A);
+    }
+
+    // Vertical (eixo Y): |py + t dy| <= h
+    if (d.y == 0.0f) {
+        if (std::fabs(p.y) > verticalSum) {
+            return false;
+        }
+    } else {
+        float t0 = (-verticalSum - p.y) / d.y;
+        float t1 = (verticalSum - p.y) / d.y;
+        t_min = std::max(t_min, std::min(t0, t1));
+        t_max = std::min(t_max, std::max(t0, t1));
+    }
+
+    if (t_min > t_max) {
+        return false;
+    }
+
+    t_out = t_min;
+    return true;
+}
+
+// --- Testes em Lote ---
+
+// Conjunto de valores de um lote: um por candidata, ou um valor comum
+struct BatchValues {
+    const float* values;
+    float common;
+
+    float at(size_t i) const { return values ? values[i] : common; }
+};
+
+static const unsigned char maskBitCount[16] = { 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4 };
+
+// Zera a máscara antes de um lote
+static void clearHitMask(unsigned int* hits, size_t n) {
+    if (hits)
+        std::fill(hits, hits + COLLISION_MASK_WORDS(n), 0u);
+}
+
+// Acrescenta à máscara os bits "bits" das candidatas i, i + 1, ... (i é
+// múltiplo do número de candidatas do bloco, então o bloco não cruza palavras)
+static size_t addHitBits(unsigned int* hits, size_t i, unsigned int bits) {
+    if (hits)
+        hits[i / 32] |= bits << (i % 32);
+    return maskBitCount[bits & 15] + maskBitCount[(bits >> 4) & 15];
+}
+
+// Marca a candidata i na máscara
+static size_t addHit(unsigned int* hits, size_t i) {
+    if (hits)
+        hits[i / 32] |= 1u << (i % 32);
+    return 1;
+}
+
+#ifdef COLLISIONS_USE_AVX
+static inline __m256 loadBatch8(const BatchValues& v, size_t i) {
+    return v.values ? _mm256_loadu_ps(v.values + i) : _mm256_set1_ps(v.common);
+}
+#endif
+
+#ifdef COLLISIONS_USE_SSE
+static inline __m128 loadBatch4(const BatchValues& v, size_t i) {
+    return v.values ? _mm_loadu_ps(v.values + i) : _mm_set1_ps(v.common);
+}
+#endif
+
+static size_t sphereSphereBatch(const BoundingSphere& sphere, const float* x, const float* y, const float* z,
+                                const BatchValues& radius, size_t n, unsigned int* hits) {
+    clearHitMask(hits, n);
+    const glm::vec4& c = sphere.center;
+    size_t count = 0;
+    size_t i = 0;
+
+#ifdef COLLISIONS_USE_AVX
+    {
+        __m256 cx = _mm256_set1_ps(c.x), cy = _mm256_set1_ps(c.y), cz = _mm256_set1_ps(c.z);
+        __m256 r = _mm256_set1_ps(sphere.radius);
+        for (; i + 8 <= n; i += 8) {
+            __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(x + i), cx);
+            __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(y + i), cy);
+            __m256 dz = _mm256_sub_ps(_mm256_loadu_ps(z + i), cz);
+            __m256 d2 = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)), _mm256_mul_ps(dz, dz));
+            __m256 rs = _mm256_add_ps(loadBatch8(radius, i), r);
+            count += addHitBits(hits, i, (unsigned int)_mm256_movemask_ps(_mm256_cmp_ps(d2, _mm256_mul_ps(rs, rs), _CMP_LE_OQ)));
+        }
+    }
+#endif
+
+#ifdef COLLISIONS_USE_SSE
+    {
+        __m128 cx = _mm_set1_ps(c.x), cy = _mm_set1_ps(c.y), cz = _mm_set1_ps(c.z);
+        __m128 r = _mm_set1_ps(sphere.radius);
+        for (; i + 4 <= n; i += 4) {
+            __m128 dx = _mm_sub_ps(_mm_loadu_ps(x + i), cx);
+            __m128 dy = _mm_sub_ps(_mm_loadu_ps(y + i), cy);
+            __m128 dz = _mm_sub_ps(_mm_loadu_ps(z + i), cz);
+            __m128 d2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+            __m128 rs = _mm_add_ps(loadBatch4(radius, i), r);
+            count += addHitBits(hits, i, (unsigned int)_mm_movemask_ps(_mm_cmple_ps(d2, _mm_mul_ps(rs, rs))));
+        }
+    }
+#endif
+
+    for (; i < n; ++i) {
+        float dx = x[i] - c.x;
+        float dy = y[i] - c.y;
+        float dz = z[i] - c.z;
+        float rs = radius.at(i) + sphere.radius;
+        if (dx*dx + dy*dy + dz*dz <= rs * rs)
+            count += addHit(hits, i);
+    }
+    return count;
+}
+
+static size_t raySphereBatch(const Ray& ray, const float* x, const float* y, const float* z,
+                             const BatchValues& radius, size_t n, unsigned int* hits, float* t_out) {
+    clearHitMask(hits, n);
+    const glm::vec4& o = ray.origin;
+    const glm::vec4& d = ray.direction;
+    const float no_hit = std::numeric_limits<float>::max();
+    size_t count = 0;
+    size_t i = 0;
+
+#ifdef COLLISIONS_USE_AVX
+    {
+        __m256 ox = _mm256_set1_ps(o.x), oy = _mm256_set1_ps(o.y), oz = _mm256_set1_ps(o.z);
+        __m256 dx = _mm256_set1_ps(d.x), dy = _mm256_set1_ps(d.y), dz = _mm256_set1_ps(d.z);
+        __m256 zero = _mm256_setzero_ps(), two = _mm256_set1_ps(2.0f), four = _mm256_set1_ps(4.0f), half = _mm256_set1_ps(0.5f);
+        __m256 far = _mm256_set1_ps(no_hit);
+        for (; i + 8 <= n; i += 8) {
+            __m256 lx = _mm256_sub_ps(ox, _mm256_loadu_ps(x + i));
+            __m256 ly = _mm256_sub_ps(oy, _mm256_loadu_ps(y + i));
+            __m256 lz = _mm256_sub_ps(oz, _mm256_loadu_ps(z + i));
+            __m256 r = loadBatch8(radius, i);
+            __m256 b = _mm256_mul_ps(two, _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, lx), _mm256_mul_ps(dy, ly)), _mm256_mul_ps(dz, lz)));
+            __m256 cc = _mm256_sub_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(lx, lx), _mm256_mul_ps(ly, ly)), _mm256_mul_ps(lz, lz)),
+                                      _mm256_mul_ps(r, r));
+            __m256 disc = _mm256_sub_ps(_mm256_mul_ps(b, b), _mm256_mul_ps(four, cc));
+            __m256 sq = _mm256_sqrt_ps(_mm256_max_ps(disc, zero));
+            __m256 t1 = _mm256_mul_ps(_mm256_sub_ps(_mm256_sub_ps(zero, b), sq), half);
+            __m256 t2 = _mm256_mul_ps(_mm256_add_ps(_mm256_sub_ps(zero, b), sq), half);
+
+            __m256 hit = _mm256_and_ps(_mm256_cmp_ps(disc, zero, _CMP_GE_OQ), _mm256_cmp_ps(t2, zero, _CMP_GE_OQ));
+            __m256 t = _mm256_blendv_ps(t2, t1, _mm256_cmp_ps(t1, zero, _CMP_GE_OQ));
+            if (t_out)
+                _mm256_storeu_ps(t_out + i, _mm256_blendv_ps(far, t, hit));
+            count += addHitBits(hits, i, (unsigned int)_mm256_movemask_ps(hit));
+        }
+    }
+#endif
+
+#ifdef COLLISIONS_USE_SSE
+    {
+        __m128 ox = _mm_set1_ps(o.x), oy = _mm_set1_ps(o.y), oz = _mm_set1_ps(o.z);
+        __m128 dx = _mm_set1_ps(d.x), dy = _mm_set1_ps(d.y), dz = _mm_set1_ps(d.z);
+        __m128 zero = _mm_setzero_ps(), two = _mm_set1_ps(2.0f), four = _mm_set1_ps(4.0f), half = _mm_set1_ps(0.5f);
+        __m128 far = _mm_set1_ps(no_hit);
+        for (; i + 4 <= n; i += 4) {
+            // L = origem - centro, B = 2 d.L, C = L.L - r^2 (A = 1)
+            __m128 lx = _mm_sub_ps(ox, _mm_loadu_ps(x + i));
+            __m128 ly = _mm_sub_ps(oy, _mm_loadu_ps(y + i));
+            __m128 lz = _mm_sub_ps(oz, _mm_loadu_ps(z + i));
+            __m128 r = loadBatch4(radius, i);
+            __m128 b = _mm_mul_ps(two, _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, lx), _mm_mul_ps(dy, ly)), _mm_mul_ps(dz, lz)));
+            __m128 cc = _mm_sub_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(lx, lx), _mm_mul_ps(ly, ly)), _mm_mul_ps(lz, lz)),
+                                   _mm_mul_ps(r, r));
+            __m128 disc = _mm_sub_ps(_mm_mul_ps(b, b), _mm_mul_ps(four, cc));
+            __m128 sq = _mm_sqrt_ps(_mm_max_ps(disc, zero));
+            __m128 t1 = _mm_mul_ps(_mm_sub_ps(_mm_sub_ps(zero, b), sq), half);
+            __m128 t2 = _mm_mul_ps(_mm_add_ps(_mm_sub_ps(zero, b), sq), half);
+
+            // O t mais próximo e positivo: t1 se t1 >= 0, senão t2
+            __m128 hit = _mm_and_ps(_mm_cmpge_ps(disc, zero), _mm_cmpge_ps(t2, zero));
+            __m128 use_t1 = _mm_cmpge_ps(t1, zero);
+            __m128 t = _mm_or_ps(_mm_and_ps(use_t1, t1), _mm_andnot_ps(use_t1, t2));
+            if (t_out)
+                _mm_storeu_ps(t_out + i, _mm_or_ps(_mm_and_ps(hit, t), _mm_andnot_ps(hit, far)));
+            count += addHitBits(hits, i, (unsigned int)_mm_movemask_ps(hit));
+        }
+    }
+#endif
+
+    for (; i < n; ++i) {
+        float lx = o.x - x[i];
+        float ly = o.y - y[i];
+        float lz = o.z - z[i];
+        float r = radius.at(i);
+        float b = 2.0f * (d.x*lx + d.y*ly + d.z*lz);
+        float cc = (lx*lx + ly*ly + lz*lz) - r * r;
+        float disc = b * b - 4.0f * cc;
+        float sq = std::sqrt(std::max(disc, 0.0f));
+        float t1 = (0.0f - b - sq) * 0.5f;
+        float t2 = (0.0f - b + sq) * 0.5f;
+
+        bool hit = disc >= 0.0f && t2 >= 0.0f;
+        if (t_out)
+            t_out[i] = hit ? (t1 >= 0.0f ? t1 : t2) : no_hit;
+        if (hit)
+            count += addHit(hits, i);
+    }
+    return count;
+}
+
+static size_t cylinderSphereBatch(const BoundingSphere& sphere, const float* x, const float* y, const float* z,
+                                  const BatchValues& radius, const BatchValues& height, size_t n, unsigned int* hits) {
+    clearHitMask(hits, n);
+    const glm::vec4& c = sphere.center;
+    size_t count = 0;
+    size_t i = 0;
+
+#ifdef COLLISIONS_USE_AVX
+    {
+        __m256 cx = _mm256_set1_ps(c.x), cy = _mm256_set1_ps(c.y), cz = _mm256_set1_ps(c.z);
+        __m256 r = _mm256_set1_ps(sphere.radius), half = _mm256_set1_ps(0.5f);
+        __m256 abs_mask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+        for (; i + 8 <= n; i += 8) {
+            __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(x + i), cx);
+            __m256 dz = _mm256_sub_ps(_mm256_loadu_ps(z + i), cz);
+            __m256 dy = _mm256_and_ps(_mm256_sub_ps(_mm256_loadu_ps(y + i), cy), abs_mask);
+            __m256 radial = _mm256_add_ps(loadBatch8(radius, i), r);
+            __m256 vertical = _mm256_add_ps(_mm256_mul_ps(loadBatch8(height, i), half), r);
+            __m256 d2 = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dz, dz));
+            __m256 hit = _mm256_and_ps(_mm256_cmp_ps(d2, _mm256_mul_ps(radial, radial), _CMP_LE_OQ),
+                                       _mm256_cmp_ps(dy, vertical, _CMP_LE_OQ));
+            count += addHitBits(hits, i, (unsigned int)_mm256_movemask_ps(hit));
+        }
+    }
+#endif
+
+#ifdef COLLISIONS_USE_SSE
+    {
+        __m128 cx = _mm_set1_ps(c.x), cy = _mm_set1_ps(c.y), cz = _mm_set1_ps(c.z);
+        __m128 r = _mm_set1_ps(sphere.radius), half = _mm_set1_ps(0.5f);
+        __m128 abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+        for (; i + 4 <= n; i += 4) {
+            __m128 dx = _mm_sub_ps(_mm_loadu_ps(x + i), cx);
+            __m128 dz = _mm_sub_ps(_mm_loadu_ps(z + i), cz);
+            __m128 dy = _mm_and_ps(_mm_sub_ps(_mm_loadu_ps(y + i), cy), abs_mask);
+            __m128 radial = _mm_add_ps(loadBatch4(radius, i), r);
+            __m128 vertical = _mm_add_ps(_mm_mul_ps(loadBatch4(height, i), half), r);
+            __m128 d2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dz, dz));
+            __m128 hit = _mm_and_ps(_mm_cmple_ps(d2, _mm_mul_ps(radial, radial)), _mm_cmple_ps(dy, vertical));
+            count += addHitBits(hits, i, (unsigned int)_mm_movemask_ps(hit));
+        }
+    }
+#endif
+
+    for (; i < n; ++i) {
+        float dx = x[i] - c.x;
+        float dz = z[i] - c.z;
+        float dy = std::fabs(y[i] - c.y);
+        float radial = radius.at(i) + sphere.radius;
+        float vertical = height.at(i) * 0.5f + sphere.radius;
+        if (dx*dx + dz*dz <= radial * radial && dy <= vertical)
+            count += addHit(hits, i);
+    }
+    return count;
+}
+
+size_t checkSphereSphereBatch(const BoundingSphere& sphere, const float* x, const float* y, const float* z,
+                              const float* radius, size_t n, unsigned int* hits) {
+    BatchValues r = { radius, 0.0f };
+    return sphereSphereBatch(sphere, x, y, z, r, n, hits);
+}
+
+size_t checkSphereSphereBatch(const BoundingSphere& sphere, const float* x, const float* y, const float* z,
+                              float radius, size_t n, unsigned int* hits) {
+    BatchValues r = { NULL, radius };
+    return sphereSphereBatch(sphere, x, y, z, r, n, hits);
+}
+
+size_t checkRaySphereBatch(const Ray& ray, const float* x, const float* y, const float* z,
+                           const float* radius, size_t n, unsigned int* hits, float* t_out) {
+    BatchValues r = { radius, 0.0f };
+    return raySphereBatch(ray, x, y, z, r, n, hits, t_out);
+}
+
+size_t checkRaySphereBatch(const Ray& ray, const float* x, const float* y, const float* z,
+                           float radius, size_t n, unsigned int* hits, float* t_out) {
+    BatchValues r = { NULL, radius };
+    return raySphereBatch(ray, x, y, z, r, n, hits, t_out);
+}
+
+size_t checkCylinderSphereBatch(const BoundingSphere& sphere, const float* x, const float* y, const float* z,
+                                const float* radius, const float* height, size_t n, unsigned int* hits) {
+    BatchValues r = { radius, 0.0f };
+    BatchValues h = { height, 0.0f };
+    return cylinderSphereBatch(sphere, x, y, z, r, h, n, hits);
+}
+
+size_t checkCylinderSphereBatch(const BoundingSphere& sphere, const float* x, const float* y, const float* z,
+                                float radius, float height, size_t n, unsigned int* hits) {
+    BatchValues r = { NULL, radius };
+    BatchValues h = { NULL, height };
+    return cylinderSphereBatch(sphere, x, y, z, r, h, n, hits);
+}
+
+const char* collisionBatchPath() {
+#if defined(COLLISIONS_USE_AVX)
+    return "AVX";
+#elif defined(COLLISIONS_USE_SSE)
+    return "SSE2";
+#else
+    return "escalar";
+#endif
+}
+
+size_t collisionHitList(const unsigned int* hits, size_t n, unsigned int* list) {
+    size_t count = 0;
+    for (size_t w = 0; w < COLLISION_MASK_WORDS(n); ++w) {
+        unsigned int bits = hits[w];
+        for (unsigned int b = 0; bits != 0; ++b, bits >>= 1)
+            if (bits & 1u)
+                list[count++] = (unsigned int)(w * 32 + b);
+    }
+    return count;
+}
+
+
+// --- Volumes Ajustados às Malhas ---
+
+// Autovetores da matriz simétrica 3x3 "m" (método de Jacobi): as colunas de
+// "vectors" ao final
+static void symmetricEigenvectors(double m[3][3], double vectors[3][3]) {
+    for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < 3; ++j)
+            vectors[i][j] = (i == j) ? 1.0 : 0.0;
+
+    for (int sweep = 0; sweep < 32; ++sweep) {
+        double off = m[0][1] * m[0][1] + m[0][2] * m[0][2] + m[1][2] * m[1][2];
+        if (off < 1e-18)
+            break;
+
+        for (int p = 0; p < 2; ++p) {
+            for (int q = p + 1; q < 3; ++q) {
+                if (m[p][q] == 0.0)
+                    continue;
+
+                // Rotação no plano (p, q) que zera m[p][q]
+                double theta = (m[q][q] - m[p][p]) / (2.0 * m[p][q]);
+                double t = (theta >= 0.0 ? 1.0 : -1.0) / (std::fabs(theta) + std::sqrt(theta * theta + 1.0));
+                double c = 1.0 / std::sqrt(t * t + 1.0);
+                double sn = t * c;
+
+                for (int k = 0; k < 3; ++k) {
+                    double mkp = m[k][p], mkq = m[k][q];
+                    m[k][p] = c * mkp - sn * mkq;
+                    m[k][q] = sn * mkp + c * mkq;
+                }
+                for (int k = 0; k < 3; ++k) {
+                    double mpk = m[p][k], mqk = m[q][k];
+                    m[p][k] = c * mpk - sn * mqk;
+                    m[q][k] = sn * mpk + c * mqk;
+                }
+                for (int k = 0; k < 3; ++k) {
+                    double vkp = vectors[k][p], vkq = vectors[k][q];
+                    vectors[k][p] = c * vkp - sn * vkq;
+                    vectors[k][q] = sn * vkp + c * vkq;
+                }
+            }
+        }
+    }
+}
+
+// Caixa dos vértices com os eixos dados (unitários e perpendiculares)
+static BoundingOBB fitBox(const float* vertices, size_t count, const glm::vec4 axis[3]) {
+    const float big = std::numeric_limits<float>::max();
+    float lo[3] = { big, big, big };
+    float hi[3] = { -big, -big, -big };
+    for (size_t i = 0; i < count; ++i) {
+        glm::vec4 v(vertices[3*i], vertices[3*i + 1], vertices[3*i + 2], 0.0f);
+        for (int a = 0; a < 3; ++a) {
+            float coord = dot(v, axis[a]);
+            lo[a] = std::min(lo[a], coord);
+            hi[a] = std::max(hi[a], coord);
+        }
+    }
+
+    BoundingOBB box;
+    box.center = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+    for (int a = 0; a < 3; ++a) {
+        box.axis[a] = axis[a];
+        box.halfSize[a] = 0.5f * (hi[a] - lo[a]);
+        box.center += 0.5f * (lo[a] + hi[a]) * axis[a];
+    }
+    return box;
+}
+
+static float boxVolume(const BoundingOBB& box) {
+    return box.halfSize[0] * box.halfSize[1] * box.halfSize[2];
+}
+
+MeshBounds computeMeshBounds(const float* vertices, size_t count) {
+    MeshBounds bounds;
+    glm::vec4 origin(0.0f, 0.0f, 0.0f, 1.0f);
+    glm::vec4 worldAxis[3] = { glm::vec4(1.0f, 0.0f, 0.0f, 0.0f),
+                               glm::vec4(0.0f, 1.0f, 0.0f, 0.0f),
+                               glm::vec4(0.0f, 0.0f, 1.0f, 0.0f) };
+
+    if (count == 0) {
+        bounds.sphere = { origin, 0.0f };
+        bounds.capsule = { origin, origin, 0.0f };
+        bounds.box.center = origin;
+        for (int a = 0; a < 3; ++a) {
+            bounds.box.axis[a] = worldAxis[a];
+            bounds.box.halfSize[a] = 0.0f;
+        }
+        return bounds;
+    }
+
+    // Eixos principais: autovetores da covariância dos vértices
+    double mean[3] = { 0.0, 0.0, 0.0 };
+    for (size_t i = 0; i < count; ++i)
+        for (int a = 0; a < 3; ++a)
+            mean[a] += vertices[3*i + a];
+    for (int a = 0; a < 3; ++a)
+        mean[a] /= (double)count;
+
+    double covariance[3][3] = { { 0.0 } };
+    for (size_t i = 0; i < count; ++i) {
+        double d[3];
+        for (int a = 0; a < 3; ++a)
+            d[a] = vertices[3*i + a] - mean[a];
+        for (int a = 0; a < 3; ++a)
+            for (int b = 0; b < 3; ++b)
+                covariance[a][b] += d[a] * d[b];
+    }
+
+    double vectors[3][3];
+    symmetricEigenvectors(covariance, vectors);
+
+    glm::vec4 principalAxis[3];
+    for (int a = 0; a < 3; ++a)
+        principalAxis[a] = glm::vec4((float)vectors[0][a], (float)vectors[1][a], (float)vectors[2][a], 0.0f);
+    // Base da mão direita, para que a caixa possa ser uma matriz de rotação
+    glm::vec3 z = glm::cross(glm::vec3(principalAxis[0]), glm::vec3(principalAxis[1]));
+    principalAxis[2] = glm::vec4(glm::normalize(z), 0.0f);
+
+    BoundingOBB principalBox = fitBox(vertices, count, principalAxis);
+    BoundingOBB alignedBox = fitBox(vertices, count, worldAxis);
+    bounds.box = boxVolume(principalBox) < boxVolume(alignedBox) ? principalBox : alignedBox;
+
+    // Cápsula: eixo mais comprido da caixa, pelo centro dela. O raio é a maior
+    // distância de um vértice até esse eixo, e cada ponta avança só o
+    // necessário para que a semiesfera dela cubra os vértices além do centro.
+    int longest = 0;
+    for (int a = 1; a < 3; ++a)
+        if (bounds.box.halfSize[a] > bounds.box.halfSize[longest])
+            longest = a;
+    glm::vec4 axis = bounds.box.axis[longest];
+
+    float radiusSq = 0.0f;
+    for (size_t i = 0; i < count; ++i) {
+        glm::vec4 d = glm::vec4(vertices[3*i], vertices[3*i + 1], vertices[3*i + 2], 1.0f) - bounds.box.center;
+        float along = dot(d, axis);
+        radiusSq = std::max(radiusSq, dot(d, d) - along * along);
+    }
+    float radius = std::sqrt(radiusSq);
+
+    float top = -std::numeric_limits<float>::max();
+    float bottom = std::numeric_limits<float>::max();
+    for (size_t i = 0; i < count; ++i) {
+        glm::vec4 d = glm::vec4(vertices[3*i], vertices[3*i + 1], vertices[3*i + 2], 1.0f) - bounds.box.center;
+        float along = dot(d, axis);
+        float cap = std::sqrt(std::max(radiusSq - (dot(d, d) - along * along), 0.0f));
+        top = std::max(top, along - cap);
+        bottom = std::min(bottom, along + cap);
+    }
+    if (top < bottom) {
+        top = bottom = 0.5f * (top + bottom);
+    }
+    bounds.capsule = { bounds.box.center + bottom * axis, bounds.box.center + top * axis, radius };
+
+    // Esfera de Ritter: parte dos dois vértices mais distantes entre os
+    // extremos de cada eixo e cresce até conter todos
+    size_t lo[3] = { 0, 0, 0 }, hi[3] = { 0, 0, 0 };
+    for (size_t i = 1; i < count; ++i) {
+        for (int a = 0; a < 3; ++a) {
+            if (vertices[3*i + a] < vertices[3*lo[a] + a]) lo[a] = i;
+            if (vertices[3*i + a] > vertices[3*hi[a] + a]) hi[a] = i;
+        }
+    }
+    glm::vec4 p0 = origin, p1 = origin;
+    float spanSq = -1.0f;
+    for (int a = 0; a < 3; ++a) {
+        glm::vec4 u(vertices[3*lo[a]], vertices[3*lo[a] + 1], vertices[3*lo[a] + 2], 1.0f);
+        glm::vec4 v(vertices[3*hi[a]], vertices[3*hi[a] + 1], vertices[3*hi[a] + 2], 1.0f);
+        if (distanceSq(u, v) > spanSq) {
+            spanSq = distanceSq(u, v);
+            p0 = u;
+            p1 = v;
+        }
+    }
+
+    BoundingSphere ritter = { 0.5f * (p0 + p1), 0.5f * std::sqrt(spanSq) };
+    for (size_t i = 0; i < count; ++i) {
+        glm::vec4 v(vertices[3*i], vertices[3*i + 1], vertices[3*i + 2], 1.0f);
+        float distSq = distanceSq(v, ritter.center);
+        if (distSq > ritter.radius * ritter.radius) {
+            float dist = std::sqrt(distSq);
+            float grown = 0.5f * (ritter.radius + dist);
+            ritter.center += ((grown - ritter.radius) / dist) * (v - ritter.center);
+            ritter.radius = grown;
+        }
+    }
+
+    BoundingSphere centered = { bounds.box.center, 0.0f };
+    for (size_t i = 0; i < count; ++i) {
+        glm::vec4 v(vertices[3*i], vertices[3*i + 1], vertices[3*i + 2], 1.0f);
+        centered.radius = std::max(centered.radius, distanceSq(v, centered.center));
+    }
+    centered.radius = std::sqrt(centered.radius);
+
+    bounds.sphere = ritter.radius < centered.radius ? ritter : centered;
+    bounds.sphere.center.w = 1.0f;
+    return bounds;
+}
+
+MeshBounds transformMeshBounds(const MeshBounds& bounds, const glm::mat4& transform) {
+    float scale = glm::length(glm::vec3(transform[0]));
+
+    MeshBounds result;
+    result.sphere = { transform * bounds.sphere.center, bounds.sphere.radius * scale };
+    result.capsule = { transform * bounds.capsule.a, transform * bounds.capsule.b, bounds.capsule.radius * scale };
+
+    result.box.center = transform * bounds.box.center;
+    for (int a = 0; a < 3; ++a) {
+        result.box.axis[a] = glm::normalize(transform * bounds.box.axis[a]);
+        result.box.halfSize[a] = bounds.box.halfSize[a] * scale;
+    }
+    return result;
+}
+
 BoundingCylinder getAsteroidBoundingCylinder(const glm::vec4& asteroidPosition) {
     return {
         asteroidPosition,
@@ -149,4 +987,11 @@ BoundingSphere getCheckpointBoundingSphere(const glm::vec4& checkpointPosition)
         checkpointPosition,
         CHECKPOINT_RADIUS
     };
-}
\ No newline at end of file
+}
+
+BoundingSphere getMoonOccluderSphere(const glm::vec4& moonPosition) {
+    return {
+        moonPosition,
+        MOON_OCCLUDER_RADIUS
+    };
+}
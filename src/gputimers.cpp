@@ -0,0 +1,220 @@
+// Medição do tempo gasto pela GPU em cada etapa ("pass") da renderização,
+// utilizando "timer queries" (GL_TIME_ELAPSED) de OpenGL 3.3.
+//
+// Os resultados de uma query só ficam disponíveis alguns quadros depois de
+// ela ser emitida. Para nunca bloquear a CPU esperando a GPU, cada etapa
+// possui GPUTIMERS_FRAMES conjuntos de queries usados alternadamente: em um
+// quadro emitimos as queries de um conjunto e lemos os resultados do conjunto
+// emitido no quadro anterior, somente se já estiverem disponíveis. Se a
+// query de uma etapa ainda não terminou quando o conjunto volta a ser usado,
+// a etapa não é medida nesse quadro.
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include "utils.h"
+
+#define GPUTIMERS_FRAMES 2
+
+struct GpuTimerScope
+{
+    std::string name;
+    GLuint      queries[GPUTIMERS_FRAMES];
+    bool        issued[GPUTIMERS_FRAMES];  // Query emitida e ainda não lida
+    double      sum_ms;       // Soma dos tempos lidos desde a última média
+    int         num_samples;  // Número de tempos somados em sum_ms
+    float       average_ms;   // Última média calculada (atualizada a cada segundo)
+    float       last_ms;      // Último tempo lido, usado no arquivo CSV
+    bool        fresh;        // last_ms foi lido neste quadro
+};
+
+std::vector<GpuTimerScope> gputimers_scopes;
+int    gputimers_frame = 0;      // Conjunto de queries usado no quadro atual
+int    gputimers_active = -1;    // Etapa com query aberta (-1 se nenhuma)
+double gputimers_last_average = 0.0;
+
+FILE*  gputimers_csv = NULL;
+long   gputimers_csv_frame = 0;
+
+// Retorna o índice da etapa com o nome dado, criando-a se necessário.
+static int GpuTimers_FindScope(const char* name)
+{
+    for (size_t i = 0; i < gputimers_scopes.size(); ++i)
+        if (gputimers_scopes[i].name == name)
+            return (int)i;
+
+    GpuTimerScope scope;
+    scope.name = name;
+    glGenQueries(GPUTIMERS_FRAMES, scope.queries);
+    for (int f = 0; f < GPUTIMERS_FRAMES; ++f)
+        scope.issued[f] = false;
+    scope.sum_ms = 0.0;
+    scope.num_samples = 0;
+    scope.average_ms = 0.0f;
+    scope.last_ms = 0.0f;
+    scope.fresh = false;
+    glCheckError();
+
+    gputimers_scopes.push_back(scope);
+    return (int)gputimers_scopes.size() - 1;
+}
+
+// Inicia a medição da etapa "name". Etapas não podem ser aninhadas: uma etapa
+// aberta é encerrada automaticamente quando outra começa.
+void GpuTimers_Begin(const char* name)
+{
+    if (gputimers_active >= 0)
+        glEndQuery(GL_TIME_ELAPSED);
+
+    gputimers_active = -1;
+
+    int i = GpuTimers_FindScope(name);
+    GpuTimerScope& scope = gputimers_scopes[i];
+
+    // Se a query deste conjunto ainda não tem resultado (GPU muito atrasada),
+    // ela não pode ser reutilizada sem que o driver espere pela GPU: a etapa
+    // fica sem medição neste quadro. Um resultado já disponível, mas ainda
+    // não lido, é descartado.
+    if (scope.issued[gputimers_frame])
+    {
+        GLint available = 0;
+        glGetQueryObjectiv(scope.queries[gputimers_frame], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available)
+            return;
+    }
+
+    scope.issued[gputimers_frame] = true;
+    glBeginQuery(GL_TIME_ELAPSED, scope.queries[gputimers_frame]);
+    gputimers_active = i;
+}
+
+// Encerra a medição da etapa aberta por GpuTimers_Begin().
+void GpuTimers_End()
+{
+    if (gputimers_active < 0)
+        return;
+
+    glEndQuery(GL_TIME_ELAPSED);
+    gputimers_active = -1;
+}
+
+// Deve ser chamada uma vez por quadro, após todas as etapas. Lê (sem
+// bloquear) os resultados disponíveis do conjunto que será reutilizado no
+// próximo quadro, atualiza as médias e escreve uma linha no arquivo CSV.
+void GpuTimers_EndFrame()
+{
+    GpuTimers_End();
+
+    gputimers_frame = (gputimers_frame + 1) % GPUTIMERS_FRAMES;
+
+    bool any_result = false;
+    for (size_t i = 0; i < gputimers_scopes.size(); ++i)
+    {
+        GpuTimerScope& scope = gputimers_scopes[i];
+        scope.fresh = false;
+        if (!scope.issued[gputimers_frame])
+            continue;
+
+        GLint available = 0;
+        glGetQueryObjectiv(scope.queries[gputimers_frame], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available)
+            continue;
+
+        GLuint64 elapsed_ns = 0;
+        glGetQueryObjectui64v(scope.queries[gputimers_frame], GL_QUERY_RESULT, &elapsed_ns);
+        scope.issued[gputimers_frame] = false;
+
+        scope.last_ms = (float)(elapsed_ns / 1.0e6);
+        scope.fresh = true;
+        scope.sum_ms += scope.last_ms;
+        scope.num_samples += 1;
+        any_result = true;
+    }
+
+    // Médias atualizadas uma vez por segundo, como o contador de FPS
+    double seconds = glfwGetTime();
+    if (seconds - gputimers_last_average > 1.0)
+    {
+        for (size_t i = 0; i < gputimers_scopes.size(); ++i)
+        {
+            GpuTimerScope& scope = gputimers_scopes[i];
+            if (scope.num_samples > 0)
+                scope.average_ms = (float)(scope.sum_ms / scope.num_samples);
+            scope.sum_ms = 0.0;
+            scope.num_samples = 0;
+        }
+        gputimers_last_average = seconds;
+    }
+
+    // Etapas sem resultado novo neste quadro ficam com o campo vazio, em vez
+    // de repetir o tempo de um quadro anterior
+    if (gputimers_csv && any_result)
+    {
+        fprintf(gputimers_csv, "%ld", gputimers_csv_frame++);
+        for (size_t i = 0; i < gputimers_scopes.size(); ++i)
+        {
+            if (gputimers_scopes[i].fresh)
+                fprintf(gputimers_csv, ",%.4f", gputimers_scopes[i].last_ms);
+            else
+                fprintf(gputimers_csv, ",");
+        }
+        fprintf(gputimers_csv, "\n");
+    }
+}
+
+size_t GpuTimers_Count()
+{
+    return gputimers_scopes.size();
+}
+
+const char* GpuTimers_Name(size_t i)
+{
+    return gputimers_scopes[i].name.c_str();
+}
+
+// Tempo médio (em milissegundos) da etapa i no último segundo
+float GpuTimers_AverageMs(size_t i)
+{
+    return gputimers_scopes[i].average_ms;
+}
+
+// Inicia a gravação dos tempos de cada quadro em um arquivo CSV, com uma
+// coluna por etapa (em milissegundos). Retorna false se o arquivo não puder
+// ser criado.
+bool GpuTimers_StartCsv(const char* filename)
+{
+    if (gputimers_csv)
+        fclose(gputimers_csv);
+
+    gputimers_csv = fopen(filename, "w");
+    if (!gputimers_csv)
+    {
+        fprintf(stderr, "ERROR: Cannot open file \"%s\".\n", filename);
+        return false;
+    }
+
+    fprintf(gputimers_csv, "frame");
+    for (size_t i = 0; i < gputimers_scopes.size(); ++i)
+        fprintf(gputimers_csv, ",%s_ms", gputimers_scopes[i].name.c_str());
+    fprintf(gputimers_csv, "\n");
+
+    gputimers_csv_frame = 0;
+    return true;
+}
+
+void GpuTimers_StopCsv()
+{
+    if (gputimers_csv)
+    {
+        fclose(gputimers_csv);
+        gputimers_csv = NULL;
+    }
+}
+
+bool GpuTimers_IsRecordingCsv()
+{
+    return gputimers_csv != NULL;
+}
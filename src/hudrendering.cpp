@@ -0,0 +1,155 @@
+// Renderização do HUD (Heads-Up Display) em 2D. As primitivas (retângulos e
+// barras) de um quadro são acumuladas em um vetor na CPU e desenhadas todas de
+// uma vez, com uma única chamada glDrawArrays(), por HudRendering_Flush().
+#include <vector>
+#include <string>
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <glm/vec4.hpp>
+
+#include "utils.h"
+#include "renderstats.h"
+
+GLuint CreateGpuProgram(GLuint vertex_shader_id, GLuint fragment_shader_id); // Função definida em main.cpp
+void TextRendering_LoadShader(const GLchar* const shader_string, GLuint shader_id); // Função definida em textrendering.cpp
+
+const GLchar* const hudvertexshader_source = ""
+"#version 330\n"
+"layout (location = 0) in vec2 position;\n"
+"layout (location = 1) in vec4 color;\n"
+"out vec4 color_v;\n"
+"void main()\n"
+"{\n"
+    "gl_Position = vec4(position, 0, 1);\n"
+    "color_v = color;\n"
+"}\n"
+"\0";
+
+const GLchar* const hudfragmentshader_source = ""
+"#version 330\n"
+"in vec4 color_v;\n"
+"out vec4 fragColor;\n"
+"void main()\n"
+"{\n"
+    "fragColor = color_v;\n"
+"}\n"
+"\0";
+
+// Cada vértice do HUD: posição (x,y) em NDC e cor RGBA.
+struct HudVertex
+{
+    float x, y;
+    float r, g, b, a;
+};
+
+GLuint hudVAO;
+GLuint hudVBO;
+GLuint hudprogram_id;
+
+// Vértices acumulados no quadro atual, e capacidade atual do VBO (em vértices)
+std::vector<HudVertex> hudvertices;
+size_t hudvbo_capacity = 0;
+
+void HudRendering_Init()
+{
+    glGenBuffers(1, &hudVBO);
+    glGenVertexArrays(1, &hudVAO);
+    glCheckError();
+
+    GLuint hudvertexshader_id = glCreateShader(GL_VERTEX_SHADER);
+    TextRendering_LoadShader(hudvertexshader_source, hudvertexshader_id);
+    glCheckError();
+
+    GLuint hudfragmentshader_id = glCreateShader(GL_FRAGMENT_SHADER);
+    TextRendering_LoadShader(hudfragmentshader_source, hudfragmentshader_id);
+    glCheckError();
+
+    hudprogram_id = CreateGpuProgram(hudvertexshader_id, hudfragmentshader_id);
+    glCheckError();
+
+    // Espaço inicial para 64 retângulos; o VBO cresce se necessário.
+    hudvbo_capacity = 64 * 6;
+    hudvertices.reserve(hudvbo_capacity);
+
+    glBindVertexArray(hudVAO);
+
+    glBindBuffer(GL_ARRAY_BUFFER, hudVBO);
+    glBufferData(GL_ARRAY_BUFFER, hudvbo_capacity * sizeof(HudVertex), NULL, GL_STREAM_DRAW);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(HudVertex), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(HudVertex), (void*)(2 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+    glCheckError();
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+    glCheckError();
+}
+
+// Adiciona um retângulo com cantos (x0,y0) e (x1,y1), em NDC, ao quadro atual.
+void HudRendering_Quad(float x0, float y0, float x1, float y1, glm::vec4 color)
+{
+    HudVertex v[6] = {
+        { x0, y0, color.r, color.g, color.b, color.a },
+        { x1, y0, color.r, color.g, color.b, color.a },
+        { x1, y1, color.r, color.g, color.b, color.a },
+        { x0, y0, color.r, color.g, color.b, color.a },
+        { x1, y1, color.r, color.g, color.b, color.a },
+        { x0, y1, color.r, color.g, color.b, color.a }
+    };
+    hudvertices.insert(hudvertices.end(), v, v + 6);
+}
+
+// Adiciona uma barra de progresso: um fundo de largura "width" e, por cima,
+// uma parte preenchida a partir da esquerda proporcional a "ratio" (0 a 1).
+void HudRendering_Bar(float x, float y, float width, float height, float ratio, glm::vec4 background, glm::vec4 foreground)
+{
+    if (ratio < 0.0f) ratio = 0.0f;
+    if (ratio > 1.0f) ratio = 1.0f;
+
+    HudRendering_Quad(x, y, x + width, y + height, background);
+
+    if (ratio > 0.0f)
+        HudRendering_Quad(x, y, x + width * ratio, y + height, foreground);
+}
+
+// Desenha todas as primitivas acumuladas desde a última chamada, com uma única
+// chamada de desenho, e esvazia a lista.
+void HudRendering_Flush()
+{
+    if (hudvertices.empty())
+        return;
+
+    glBindBuffer(GL_ARRAY_BUFFER, hudVBO);
+
+    // Se necessário aumentamos o VBO. Caso contrário, "orfanamos" o buffer
+    // anterior (glBufferData com NULL) para que o driver não precise esperar
+    // o desenho do quadro anterior terminar antes da escrita.
+    if (hudvertices.size() > hudvbo_capacity)
+        hudvbo_capacity = hudvertices.capacity();
+    RenderStats_BufferData(GL_ARRAY_BUFFER, hudvbo_capacity * sizeof(HudVertex), NULL, GL_STREAM_DRAW);
+    RenderStats_BufferSubData(GL_ARRAY_BUFFER, 0, hudvertices.size() * sizeof(HudVertex), hudvertices.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    // O HUD é desenhado por cima de toda a cena 3D
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_CULL_FACE);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    RenderStats_UseProgram(hudprogram_id);
+    RenderStats_BindVertexArray(hudVAO);
+
+    RenderStats_DrawArrays(GL_TRIANGLES, 0, (GLsizei)hudvertices.size());
+
+    RenderStats_BindVertexArray(0);
+    RenderStats_UseProgram(0);
+
+    glDisable(GL_BLEND);
+    glEnable(GL_CULL_FACE);
+    glEnable(GL_DEPTH_TEST);
+
+    hudvertices.clear();
+}
@@ -0,0 +1,204 @@
+// Sistema de tarefas com roubo de trabalho. Veja "jobsystem.h".
+#include <algorithm>
+
+#include "jobsystem.h"
+
+// Fila da thread atual no sistema a que ela pertence (threads de fora de
+// qualquer sistema usam a fila 0)
+static thread_local JobSystem* tls_jobs = NULL;
+static thread_local size_t tls_queue = 0;
+
+static size_t JobSystem_CurrentQueue(const JobSystem& jobs)
+{
+    return tls_jobs == &jobs ? tls_queue : 0;
+}
+
+// Retira uma tarefa: primeiro do fim da própria fila, depois do início das
+// outras filas, começando pela seguinte
+static bool JobSystem_Pop(JobSystem& jobs, size_t own, Job& job)
+{
+    size_t n = jobs.queues.size();
+
+    for (size_t k = 0; k < n; ++k)
+    {
+        size_t q = (own + k) % n;
+        JobQueue& queue = *jobs.queues[q];
+
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.jobs.empty())
+            continue;
+
+        if (k == 0)
+        {
+            job = queue.jobs.back();
+            queue.jobs.pop_back();
+        }
+        else
+        {
+            job = queue.jobs.front();
+            queue.jobs.pop_front();
+        }
+        jobs.queued.fetch_sub(1);
+        return true;
+    }
+
+    return false;
+}
+
+static void JobSystem_Execute(Job& job)
+{
+    job.function();
+    if (job.counter)
+        job.counter->pending.fetch_sub(1);
+}
+
+static void JobSystem_Worker(JobSystem* jobs, size_t queue)
+{
+    tls_jobs = jobs;
+    tls_queue = queue;
+
+    Job job;
+    while (!jobs->quit.load())
+    {
+        if (JobSystem_Pop(*jobs, queue, job))
+        {
+            JobSystem_Execute(job);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(jobs->sleepMutex);
+        jobs->wake.wait(lock, [jobs] { return jobs->quit.load() || jobs->queued.load() > 0; });
+    }
+}
+
+void JobSystem_Init(JobSystem& jobs, int num_threads)
+{
+    JobSystem_Shutdown(jobs);
+
+    if (num_threads <= 0)
+        num_threads = std::max(1u, std::thread::hardware_concurrency());
+
+    jobs.quit = false;
+    for (int i = 0; i < num_threads; ++i)
+        jobs.queues.push_back(new JobQueue());
+}
+
+// Cria as threads auxiliares preparadas por JobSystem_Init(). Chamada pela
+// thread dona do sistema ao agendar a primeira tarefa: antes disso nenhuma
+// tarefa existe, então nenhuma outra thread agenda tarefas ao mesmo tempo.
+static void JobSystem_Start(JobSystem& jobs)
+{
+    jobs.started = true;
+    for (size_t i = 1; i < jobs.queues.size(); ++i)
+        jobs.threads.push_back(std::thread(JobSystem_Worker, &jobs, i));
+}
+
+void JobSystem_Shutdown(JobSystem& jobs)
+{
+    {
+        std::lock_guard<std::mutex> lock(jobs.sleepMutex);
+        jobs.quit = true;
+    }
+    jobs.wake.notify_all();
+
+    for (size_t i = 0; i < jobs.threads.size(); ++i)
+        jobs.threads[i].join();
+    jobs.threads.clear();
+    jobs.started = false;
+
+    for (size_t i = 0; i < jobs.queues.size(); ++i)
+        delete jobs.queues[i];
+    jobs.queues.clear();
+    jobs.queued = 0;
+}
+
+JobSystem::~JobSystem()
+{
+    JobSystem_Shutdown(*this);
+}
+
+int JobSystem_ThreadCount(const JobSystem& jobs)
+{
+    return (int)std::max((size_t)1, jobs.queues.size());
+}
+
+void JobSystem_Run(JobSystem& jobs, const std::function<void()>& function, JobCounter* counter)
+{
+    if (jobs.queues.empty())
+        JobSystem_Init(jobs, 1);
+    if (!jobs.started)
+        JobSystem_Start(jobs);
+
+    Job job;
+    job.function = function;
+    job.counter = counter;
+    if (counter)
+        counter->pending.fetch_add(1);
+
+    // "queued" é incrementado antes de a tarefa entrar na fila (quem a retirar
+    // sempre encontra o contador já incrementado) e com sleepMutex, para que
+    // nenhuma thread durma entre testar "queued" e começar a esperar
+    {
+        std::lock_guard<std::mutex> lock(jobs.sleepMutex);
+        jobs.queued.fetch_add(1);
+    }
+
+    JobQueue& queue = *jobs.queues[JobSystem_CurrentQueue(jobs)];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.push_back(job);
+    }
+    jobs.wake.notify_one();
+}
+
+void JobSystem_RunAfter(JobSystem& jobs, JobCounter& dependency, const std::function<void()>& function, JobCounter* counter)
+{
+    JobSystem* system = &jobs;
+    JobCounter* dep = &dependency;
+    std::function<void()> after = function;
+
+    JobSystem_Run(jobs, [system, dep, after] {
+        JobSystem_Wait(*system, *dep);
+        after();
+    }, counter);
+}
+
+void JobSystem_Wait(JobSystem& jobs, JobCounter& counter)
+{
+    size_t own = JobSystem_CurrentQueue(jobs);
+
+    Job job;
+    while (counter.pending.load() > 0)
+    {
+        if (JobSystem_Pop(jobs, own, job))
+            JobSystem_Execute(job);
+        else
+            std::this_thread::yield();
+    }
+}
+
+void JobSystem_ParallelFor(JobSystem& jobs, size_t n, size_t grain,
+                           const std::function<void(size_t, size_t)>& body)
+{
+    if (grain == 0)
+        grain = 1;
+
+    // Um único bloco: executa direto, sem passar pelas filas
+    if (n <= grain)
+    {
+        if (n > 0)
+            body(0, n);
+        return;
+    }
+
+    JobCounter counter;
+    const std::function<void(size_t, size_t)>* f = &body;
+
+    for (size_t begin = 0; begin < n; begin += grain)
+    {
+        size_t end = std::min(n, begin + grain);
+        JobSystem_Run(jobs, [f, begin, end] { (*f)(begin, end); }, &counter);
+    }
+
+    JobSystem_Wait(jobs, counter);
+}
@@ -18,6 +18,7 @@
 #include <cmath>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 
 // Headers abaixo são específicos de C++
 #include <set>
@@ -49,18 +50,19 @@
 #include "utils.h"
 #include "matrices.h"
 #include "collisions.h"
+#include "simulation.h"
+#include "meshcollider.h"
+#include "jobsystem.h"
+#include "renderstats.h"
 
 #define SKYBOX 0
 #define AIRCRAFT 1
 #define PLANE 2
 #define ENEMY 3
 #define CHECKPOINT_SPHERE 4
-#define HEALTH_BAR_BACKGROUND 5
-#define HEALTH_BAR_FOREGROUND 6
 #define ASTEROID 7
 #define MISSILE 8
 
-#define MAX_LIFE 3
 #define M_PI_2 1.57079632679489661923
 #define M_PI 3.14159265358979323846
 
@@ -122,23 +124,6 @@ struct ObjModel
     }
 };
 
-struct Enemy {
-    glm::vec4 position;     // Posição no mundo
-    glm::vec4 forward;      // Para onde ele está olhando/indo
-    float speed;            // Velocidade de movimento
-    float changeDirTimer;   // Tempo até a próxima mudança de direção aleatória
-};
-
-struct Missile {
-    glm::vec4 position;     // Posição no mundo
-    glm::vec4 forward;      // Direção do voo (tangente à órbita)
-    float speed;            // Velocidade
-    float fixedDistance;    // Distância fixa da órbita (16.0f)
-    bool isActive;          // Se está ativo no jogo
-    int ownerId;            // Quem disparou (0: Nave, 1: Inimigo ID)
-    float lifeTime;         // Tempo de vida (para auto-destruição)
-};
-
 // Declaração de funções utilizadas para pilha de matrizes de modelagem.
 void PushMatrix(glm::mat4 M);
 void PopMatrix(glm::mat4& M);
@@ -147,8 +132,11 @@ void PopMatrix(glm::mat4& M);
 // logo após a definição de main() neste arquivo.
 void BuildTrianglesAndAddToVirtualScene(ObjModel*); // Constrói representação de um ObjModel como malha de triângulos para renderização
 void ComputeNormals(ObjModel* model); // Computa normais de um ObjModel, caso não existam.
+float ComputeShapeRadius(ObjModel* model, const char* shape_name); // Maior distância da origem do modelo a um vértice da peça
 void LoadShadersFromFiles(); // Carrega os shaders de vértice e fragmento, criando um programa de GPU
 void LoadTextureImage(const char* filename); // Função que carrega imagens de textura
+void LoadCubemapFromEquirectangular(const char* filename); // Converte uma imagem equiretangular em cubemap
+void DrawSkybox(const glm::mat4& view, const glm::mat4& projection); // Desenha o céu com um único triângulo
 void DrawVirtualObject(const char* object_name); // Desenha um objeto armazenado em g_VirtualScene
 GLuint LoadShader_Vertex(const char* filename);   // Carrega um vertex shader
 GLuint LoadShader_Fragment(const char* filename); // Carrega um fragment shader
@@ -162,18 +150,42 @@ void TextRendering_Init();
 float TextRendering_LineHeight(GLFWwindow* window);
 float TextRendering_CharWidth(GLFWwindow* window);
 void TextRendering_PrintString(GLFWwindow* window, const std::string &str, float x, float y, float scale = 1.0f);
+void TextRendering_PrintStringRetained(GLFWwindow* window, const char* str, float x, float y, float scale = 1.0f); // Layout e VBO reaproveitados enquanto o texto não muda
+void TextRendering_Flush(); // Desenha todo o texto do quadro (textos retidos e os demais, uma chamada de desenho cada)
 void TextRendering_PrintMatrix(GLFWwindow* window, glm::mat4 M, float x, float y, float scale = 1.0f);
 void TextRendering_PrintVector(GLFWwindow* window, glm::vec4 v, float x, float y, float scale = 1.0f);
 void TextRendering_PrintMatrixVectorProduct(GLFWwindow* window, glm::mat4 M, glm::vec4 v, float x, float y, float scale = 1.0f);
 void TextRendering_PrintMatrixVectorProductMoreDigits(GLFWwindow* window, glm::mat4 M, glm::vec4 v, float x, float y, float scale = 1.0f);
 void TextRendering_PrintMatrixVectorProductDivW(GLFWwindow* window, glm::mat4 M, glm::vec4 v, float x, float y, float scale = 1.0f);
 
+// Declaração de funções auxiliares para desenhar o HUD em 2D (barras e
+// retângulos) com uma única chamada de desenho por quadro. Estas funções estão
+// definidas no arquivo "hudrendering.cpp".
+void HudRendering_Init();
+void HudRendering_Quad(float x0, float y0, float x1, float y1, glm::vec4 color);
+void HudRendering_Bar(float x, float y, float width, float height, float ratio, glm::vec4 background, glm::vec4 foreground);
+void HudRendering_Flush();
+
+// Declaração de funções para medir o tempo de GPU de cada etapa da
+// renderização. Estas funções estão definidas no arquivo "gputimers.cpp".
+void GpuTimers_Begin(const char* name);
+void GpuTimers_End();
+void GpuTimers_EndFrame();
+size_t GpuTimers_Count();
+const char* GpuTimers_Name(size_t i);
+float GpuTimers_AverageMs(size_t i);
+bool GpuTimers_StartCsv(const char* filename);
+void GpuTimers_StopCsv();
+bool GpuTimers_IsRecordingCsv();
+
 // Funções abaixo renderizam como texto na janela OpenGL algumas matrizes e
 // outras informações do programa. Definidas após main().
 void TextRendering_ShowModelViewProjection(GLFWwindow* window, glm::mat4 projection, glm::mat4 view, glm::mat4 model, glm::vec4 p_model);
 void TextRendering_ShowEulerAngles(GLFWwindow* window);
 void TextRendering_ShowProjection(GLFWwindow* window);
 void TextRendering_ShowFramesPerSecond(GLFWwindow* window);
+void TextRendering_ShowGpuTimers(GLFWwindow* window);
+void TextRendering_ShowRenderStats(GLFWwindow* window);
 
 // Funções callback para comunicação com o sistema operacional e interação do
 // usuário. Veja mais comentários nas definições das mesmas, abaixo.
@@ -183,20 +195,8 @@ void KeyCallback(GLFWwindow* window, int key, int scancode, int action, int mode
 void MouseButtonCallback(GLFWwindow* window, int button, int action, int mods);
 void CursorPosCallback(GLFWwindow* window, double xpos, double ypos);
 void ScrollCallback(GLFWwindow* window, double xoffset, double yoffset);
-void moveAircraft(float tprev, float tnow, glm::vec4& aircraft_position);
-float randomFloat(float min, float max);
-void InitEnemies();
-void moveEnemies(float tprev, float tnow);
-glm::vec4 evaluateBezier(glm::vec4 p0, glm::vec4 p1, glm::vec4 p2, glm::vec4 p3, float t);
-void processCollisions();
-glm::vec4 normalizedVec(glm::vec4 v);
-bool isGameOver();
-void resetGame();
 void showText(GLFWwindow* window);
-void initCheckpoints();
-void initRandomAsteroids();
-void fireMissile(const glm::vec4& startPos, const glm::vec4& direction, int ownerId);
-void updateMissiles(float tprev, float tnow);
+bool isHiddenBehindMoon(const glm::vec4& camera_position, const glm::vec4& center, float radius);
 
 
 // Definimos uma estrutura que armazenará dados necessários para renderizar
@@ -259,6 +259,17 @@ bool g_UsePerspectiveProjection = true;
 // Variável que controla se o texto informativo será mostrado na tela.
 bool g_ShowInfoText = true;
 
+// Variável que controla se o FPS e os tempos de GPU de cada etapa serão
+// mostrados na tela (tecla F2). A tecla F3 liga/desliga a gravação desses
+// tempos no arquivo "gpu_timers.csv".
+bool g_ShowPerformanceOverlay = false;
+
+// Variável que controla se os contadores de renderização do último quadro
+// (chamadas de desenho, triângulos, uniforms, ...) serão mostrados na tela
+// (tecla F4). A tecla F5 liga/desliga o log desses contadores no arquivo
+// "render_stats.csv". Veja "renderstats.cpp".
+bool g_ShowRenderStats = false;
+
 // Variáveis que definem um programa de GPU (shaders). Veja função LoadShadersFromFiles().
 GLuint g_GpuProgramID = 0;
 GLint g_model_uniform;
@@ -270,66 +281,48 @@ GLint g_bbox_max_uniform;
 GLint g_gouraud_uniform;
 GLint g_is_damaged_uniform;
 
+// Programa de GPU do céu (shader_sky_vertex.glsl e shader_sky_fragment.glsl).
+GLuint g_SkyProgramID = 0;
+GLint g_sky_inverse_view_projection_uniform;
+GLuint g_SkyVertexArrayObjectID = 0; // VAO vazio: os vértices são gerados no shader
+GLint g_SkyboxTextureUnit = -1;      // Unidade de textura do cubemap (-1 antes de carregá-lo)
+
 // Número de texturas carregadas pela função LoadTextureImage()
 GLuint g_NumLoadedTextures = 0;
 
-// Variáveis que controlam a posição da aeronave no mundo
-glm::vec4 g_AircraftPosition = glm::vec4(0.0f, 0.0f, 16.0f, 1.0f);
-glm::vec4 g_AircraftForward = glm::vec4(1.0f, 0.0f, 0.0f, 0.0f);
-glm::vec4 g_AircraftPosition_Prev = glm::vec4(g_AircraftPosition); // Inicializa com a posição inicial.
-
-// Lista global de inimigos
-std::vector<Enemy> g_Enemies;
+// Estado da partida (nave, inimigos, checkpoints, asteroides e mísseis) e
+// teclas pressionadas pelo jogador. Veja "simulation.h".
+GameState g_Game;
+SimInput g_Input;
 
-// Flags para controle de movimento
-float isWPressed = false;
-float isAPressed = false;
-float isDPressed = false;
-float isIPressed = false;
+// Triângulos das peças da nave (usada também pelos inimigos), para o teste
+// de colisão mais preciso. Veja Sim_SetAircraftMesh().
+MeshCollider g_AircraftMesh;
 
-// Variaveis de posição da lua
-glm::vec4 moon_position = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+// Threads usadas pela simulação em cenários com muitas entidades
+JobSystem g_Jobs;
 
-std::vector<glm::vec4> g_Checkpoints; // Posições dos 5 Checkpoints
-
-const float turnRate = 2.0f; // Velocidade máxima de giro
-const float enemySpeed = 5.0f; // Velocidade do inimigo
+// A simulação (movimento, colisões, timers) avança em passos fixos de
+// simulationStep segundos, independentemente da taxa de quadros. O tempo real
+// decorrido é acumulado e consumido em passos inteiros; no máximo
+// maxSimulationSteps passos são executados por quadro, e o restante é
+// descartado, para que um travamento longo não gere uma "espiral" de passos.
+// A renderização interpola entre os dois últimos estados da simulação.
+const double simulationStep = 1.0 / 60.0;
+const int maxSimulationSteps = 5;
 
 // Variaveis globais de controle da Câmera Livre
 bool g_UseFirstPersonCamera = false;
 
-int g_AircraftLife = 3;
-bool g_IsGameOver = false;
-
-glm::vec4 g_Asteroid_P0 = glm::vec4(21.0f, 0.0f, 0.0f, 1.0f);
-glm::vec4 g_Asteroid_P1 = glm::vec4(17.0f, 4.0f, 4.0f, 1.0f);
-glm::vec4 g_Asteroid_P2 = glm::vec4(25.0f, 4.0f, -4.0f, 1.0f);
-glm::vec4 g_Asteroid_P3 = glm::vec4(21.0f, 0.0f, 0.0f, 1.0f);
-float g_Asteroid_t = 0.0f;
-const float asteroidSpeed = 0.50f;
-const float asteroidScale = 0.0004f;
-
-std::vector<glm::vec4> g_RandomAsteroids;
-const int numRandomAsteroids = 8;
+// Raios das esferas envolventes usadas para descartar (culling) entidades
+// escondidas atrás da lua. Calculados a partir das escalas de cada modelo.
+const float enemyCullRadius = 0.8f;      // aircraft.obj escalado por 0.05
+const float checkpointCullRadius = 1.0f; // sphere.obj escalado por 0.25/15
+const float asteroidCullRadius = 0.7f;   // asteroid.obj escalado por asteroidScale
 
-// Variável Global para armazenar todos os mísseis
-std::vector<Missile> g_Missiles;
-const float missileSpeed = 20.0f;
-const float missileLifespan = 2.0f; // 2 segundos de vida
-const float missileRadius = 0.15f;
-
-// Variáveis de controle de tiro da nave
-float g_PlayerShotTimer = 0.0f;
-const float shootColdownTimer = 1.0f; // Intervalo de 1s entre tiros
-
-const float enemyShotSpeed = 7.0f; // Inimigo atira a cada 5 segundos
-
-// Feedback de dano
-float g_DamageTimer = 0.0f;
-const float damageDuration = 0.2f; // Nave fica vermelha por 0.2 segundos
-
-// Voo livre
-bool g_FreeWorld = false;
+// A peça R-40TL fica longe da origem do modelo, então o raio do míssil é
+// calculado dos vértices dela ao carregar aircraft.obj (escala 0.1)
+float g_MissileCullRadius = 0.95f;
 
 int main(int argc, char* argv[])
 {
@@ -410,9 +403,15 @@ int main(int argc, char* argv[])
     LoadTextureImage("../../data/textures/moon.jpg"); // TextureImage2
     LoadTextureImage("../../data/textures/asteroid.jpg"); // TextureImage3
 
+    // O céu é desenhado a partir de um cubemap convertido da mesma imagem
+    // equiretangular usada em TextureImage0.
+    LoadCubemapFromEquirectangular("../../data/textures/skybox.jpeg"); // SkyboxCubemap
+    glGenVertexArrays(1, &g_SkyVertexArrayObjectID);
+
     ObjModel aircraft_model("../../data/aircraft.obj");
     ComputeNormals(&aircraft_model);
     BuildTrianglesAndAddToVirtualScene(&aircraft_model);
+    g_MissileCullRadius = std::max(g_MissileCullRadius, 0.1f * ComputeShapeRadius(&aircraft_model, "R-40TL"));
 
     ObjModel skybox_model("../../data/sphere.obj");
     ComputeNormals(&skybox_model);
@@ -431,6 +430,9 @@ int main(int argc, char* argv[])
     // Inicializamos o código para renderização de texto.
     TextRendering_Init();
 
+    // Inicializamos o código para renderização do HUD.
+    HudRendering_Init();
+
     // Habilitamos o Z-buffer. Veja slides 104-116 do documento Aula_09_Projecoes.pdf.
     glEnable(GL_DEPTH_TEST);
 
@@ -439,12 +441,40 @@ int main(int argc, char* argv[])
     glCullFace(GL_BACK);
     glFrontFace(GL_CCW);
 
-    float tprev = glfwGetTime();
-    float tnow;
-
-    InitEnemies();
-    initCheckpoints();
-    initRandomAsteroids();
+    double tprev = glfwGetTime();
+    double tnow;
+    double simulation_accumulator = 0.0;
+
+    // Iniciamos a partida. A semente é fixa, como era com rand() sem srand():
+    // a primeira partida é sempre igual.
+    Sim_Reset(g_Game, 1);
+
+    // As threads do sistema de tarefas só são criadas se a partida chegar a
+    // ter entidades suficientes para a simulação dividir o trabalho
+    JobSystem_Init(g_Jobs);
+
+    // Volumes de colisão ajustados aos vértices das malhas, levados para o
+    // referencial das entidades com as mesmas escalas e rotações usadas ao
+    // desenhá-las
+    glm::mat4 aircraft_transform = Matrix_Scale(0.05f, 0.05f, 0.05f) * Matrix_Rotate_Y(M_PI_2 * 2);
+    MeshBounds aircraft_bounds = transformMeshBounds(
+        computeMeshBounds(aircraft_model.attrib.vertices.data(), aircraft_model.attrib.vertices.size() / 3),
+        aircraft_transform);
+    MeshBounds asteroid_bounds = transformMeshBounds(
+        computeMeshBounds(asteroid_model.attrib.vertices.data(), asteroid_model.attrib.vertices.size() / 3),
+        Matrix_Scale(asteroidScale, asteroidScale, asteroidScale));
+    Sim_SetMeshBounds(g_Game, aircraft_bounds, asteroid_bounds);
+
+    // Uma BVH de triângulos para cada peça da nave, no mesmo referencial
+    for (size_t i = 0; i < aircraft_model.shapes.size(); ++i) {
+        const tinyobj::mesh_t& mesh = aircraft_model.shapes[i].mesh;
+        std::vector<unsigned int> indices(mesh.indices.size());
+        for (size_t k = 0; k < indices.size(); ++k)
+            indices[k] = (unsigned int)mesh.indices[k].vertex_index;
+        MeshCollider_AddPart(g_AircraftMesh, aircraft_model.shapes[i].name.c_str(), aircraft_model.attrib.vertices.data(),
+                             indices.data(), indices.size() / 3, aircraft_transform);
+    }
+    Sim_SetAircraftMesh(g_Game, &g_AircraftMesh);
 
     bool gouraud = false;
 
@@ -467,10 +497,37 @@ int main(int argc, char* argv[])
 
         // Pedimos para a GPU utilizar o programa de GPU criado acima (contendo
         // os shaders de vértice e fragmentos).
-        glUseProgram(g_GpuProgramID);
+        RenderStats_UseProgram(g_GpuProgramID);
 
         tnow = glfwGetTime();
 
+        // Avançamos a simulação em passos fixos, consumindo o tempo real
+        // acumulado desde o quadro anterior.
+        simulation_accumulator += tnow - tprev;
+        tprev = tnow;
+
+        int simulation_steps = 0;
+        while (simulation_accumulator >= simulationStep && simulation_steps < maxSimulationSteps)
+        {
+            Sim_Step(g_Game, g_Input, (float)simulationStep, &g_Jobs);
+
+            // O disparo vale somente para o primeiro passo após a tecla
+            g_Input.fire = false;
+            simulation_accumulator -= simulationStep;
+            simulation_steps++;
+        }
+
+        // Atrasos maiores que maxSimulationSteps passos são descartados
+        if (simulation_steps == maxSimulationSteps && simulation_accumulator >= simulationStep)
+            simulation_accumulator = 0.0;
+
+        // Fração do próximo passo já decorrida, usada para interpolar entre o
+        // estado anterior e o atual da simulação
+        float alpha = (float)(simulation_accumulator / simulationStep);
+
+        glm::vec4 aircraft_position = Sim_InterpolateOrbitPosition(g_Game.aircraftPositionPrev, g_Game.aircraftPosition, alpha);
+        glm::vec4 aircraft_forward = Sim_InterpolateDirection(g_Game.aircraftForwardPrev, g_Game.aircraftForward, alpha);
+
         glm::mat4 model = Matrix_Identity();
         glm::mat4 aircraft = Matrix_Identity();
 
@@ -484,16 +541,13 @@ int main(int argc, char* argv[])
         glm::vec4 camera_view_vector;
 
         if (!g_UseFirstPersonCamera){
-            up_vec = normalizedVec(g_AircraftPosition - moon_position);
-            front_vec = normalizedVec(g_AircraftForward - dotproduct(g_AircraftForward, up_vec) * up_vec);
-
-            // Atualizamos a global para evitar drift
-            g_AircraftForward = front_vec;
+            up_vec = normalizedVec(aircraft_position - moon_position);
+            front_vec = normalizedVec(aircraft_forward - dotproduct(aircraft_forward, up_vec) * up_vec);
 
             right_vec = normalizedVec(crossproduct(up_vec, front_vec));
 
             // O ponto para onde a câmera olha (LookAt) é a própria nave
-            camera_lookat_l = g_AircraftPosition;
+            camera_lookat_l = aircraft_position;
 
             // Calculamos o deslocamento local baseado no mouse (Theta/Phi) e Distância
             float r = g_CameraDistance;
@@ -516,10 +570,8 @@ int main(int argc, char* argv[])
             camera_view_vector = camera_lookat_l - camera_position_c;
         } else {
             // mesmo processo de cima
-            up_vec = normalizedVec(g_AircraftPosition - moon_position);
-            front_vec = normalizedVec(g_AircraftForward - dotproduct(g_AircraftForward, up_vec) * up_vec);
-
-            g_AircraftForward = front_vec;
+            up_vec = normalizedVec(aircraft_position - moon_position);
+            front_vec = normalizedVec(aircraft_forward - dotproduct(aircraft_forward, up_vec) * up_vec);
 
             right_vec = normalizedVec(crossproduct(up_vec, front_vec));
 
@@ -527,7 +579,7 @@ int main(int argc, char* argv[])
             float offset_forward = 0.15f;
             float offset_up      = 0.235f;
 
-            camera_position_c = g_AircraftPosition
+            camera_position_c = aircraft_position
                                 + (front_vec * offset_forward)
                                 + (up_vec    * offset_up);
 
@@ -539,27 +591,6 @@ int main(int argc, char* argv[])
             camera_view_vector = camera_lookat_l - camera_position_c;
         }
 
-        // se o jogo nao acabou, está inicializado e nao esta em free flight
-        if (!isGameOver() && isIPressed && !g_FreeWorld)
-        {
-            moveAircraft(tprev, tnow, g_AircraftPosition);
-            moveEnemies(tprev, tnow);
-            updateMissiles(tprev, tnow);
-            processCollisions();
-        } else if (g_FreeWorld && !isIPressed){ // se o jogo esta em free flight nao pode estar iniciado
-            moveAircraft(tprev, tnow, g_AircraftPosition);
-        }
-
-        // calculo delta t para deslocamentos
-        float delta_t = tnow - tprev;
-        g_Asteroid_t += asteroidSpeed * delta_t;
-
-        // curva de bezier
-        if (g_Asteroid_t >= 1.0f) {
-            // Reinicia o tempo para loopar a curva local
-            g_Asteroid_t = 0.0f;
-        }
-
         view = Matrix_Camera_View(camera_position_c, camera_view_vector, camera_up_vector);
 
         // Agora computamos a matriz de Projeção.
@@ -594,28 +625,12 @@ int main(int argc, char* argv[])
         // Enviamos as matrizes "view" e "projection" para a placa de vídeo
         // (GPU). Veja o arquivo "shader_vertex.glsl", onde estas são
         // efetivamente aplicadas em todos os pontos.
-        glUniformMatrix4fv(g_view_uniform       , 1 , GL_FALSE , glm::value_ptr(view));
-        glUniformMatrix4fv(g_projection_uniform , 1 , GL_FALSE , glm::value_ptr(projection));
-
-        // para decrementar o damage feedback, faz com que ele desapareça
-        if (g_DamageTimer > 0.0f) {
-            g_DamageTimer -= delta_t;
-        }
+        RenderStats_UniformMatrix4fv(g_view_uniform       , 1 , GL_FALSE , glm::value_ptr(view));
+        RenderStats_UniformMatrix4fv(g_projection_uniform , 1 , GL_FALSE , glm::value_ptr(projection));
 
         // passa se levou um dano para o shader
-        bool is_damaged = (g_DamageTimer > 0.0f);
-        glUniform1i(g_is_damaged_uniform, is_damaged);
-
-        // Desenha Infinito ao redor da cena
-        model = Matrix_Translate(camera_position_c.x,camera_position_c.y,camera_position_c.z) * Matrix_Scale(1.0f/60.0f, 1.0f/60.0f, 1.0f/60.0f);
-        glUniformMatrix4fv(g_model_uniform, 1 , GL_FALSE , glm::value_ptr(model));
-        glUniform1i(g_object_id_uniform, SKYBOX);
-        glDisable(GL_DEPTH_TEST);
-        glDisable(GL_CULL_FACE);
-        DrawVirtualObject("the_sphere");
-        glActiveTexture(GL_TEXTURE0);
-        glEnable(GL_CULL_FACE);
-        glEnable(GL_DEPTH_TEST);
+        bool is_damaged = g_Game.isDamaged;
+        RenderStats_Uniform1i(g_is_damaged_uniform, is_damaged);
 
 
         // para alinhar a nave com a lua
@@ -625,15 +640,17 @@ int main(int argc, char* argv[])
         rotation_align[2] = front_vec; // Coluna 2: Eixo Z (Front)
 
         gouraud = false;
-        glUniform1i(g_gouraud_uniform, gouraud);
+        RenderStats_Uniform1i(g_gouraud_uniform, gouraud);
+
+        GpuTimers_Begin("ships");
 
         // Desenhamos o modelo da nave
-        aircraft =  Matrix_Translate(g_AircraftPosition.x, g_AircraftPosition.y, g_AircraftPosition.z)
+        aircraft =  Matrix_Translate(aircraft_position.x, aircraft_position.y, aircraft_position.z)
          * rotation_align
          * Matrix_Scale(0.05f, 0.05f, 0.05f)
          * Matrix_Rotate_Y(M_PI_2 * 2);
-        glUniformMatrix4fv(g_model_uniform, 1 , GL_FALSE , glm::value_ptr(aircraft));
-        glUniform1i(g_object_id_uniform, AIRCRAFT);
+        RenderStats_UniformMatrix4fv(g_model_uniform, 1 , GL_FALSE , glm::value_ptr(aircraft));
+        RenderStats_Uniform1i(g_object_id_uniform, AIRCRAFT);
 
         // desenha todas as peças do objeto aircraft
         for (size_t i = 0; i < aircraft_model.shapes.size(); i++)
@@ -644,10 +661,17 @@ int main(int argc, char* argv[])
         }
 
         // Loop para desenhar todos os inimigos
-        for (const auto &enemy : g_Enemies) {
-            glm::vec4 enemy_pos = enemy.position;
+        const EnemyArray& enemies = g_Game.enemies;
+        for (size_t e = 0; e < enemies.size(); ++e) {
+            glm::vec4 enemy_pos = Sim_InterpolateOrbitPosition(enemies.prevPosition(e), enemies.position(e), alpha);
+
+            // Inimigos do outro lado da lua não são desenhados
+            if (isHiddenBehindMoon(camera_position_c, enemy_pos, enemyCullRadius))
+                continue;
+
             glm::vec4 up_e = normalizedVec(enemy_pos - moon_position);
-            glm::vec4 front_e = enemy.forward;
+            glm::vec4 front_e = Sim_InterpolateDirection(enemies.prevForward(e), enemies.forward(e), alpha);
+            front_e = normalizedVec(front_e - dotproduct(front_e, up_e) * up_e);
             glm::vec4 right_e = normalizedVec(crossproduct(up_e, front_e));
 
             glm::mat4 rotation_align_enemy = glm::mat4(1.0f);
@@ -660,128 +684,100 @@ int main(int argc, char* argv[])
                     * Matrix_Scale(0.05f, 0.05f, 0.05f)
                     * Matrix_Rotate_Y(M_PI_2 * 2);
 
-            glUniformMatrix4fv(g_model_uniform, 1 , GL_FALSE , glm::value_ptr(model));
-            glUniform1i(g_object_id_uniform, ENEMY);
+            RenderStats_UniformMatrix4fv(g_model_uniform, 1 , GL_FALSE , glm::value_ptr(model));
+            RenderStats_Uniform1i(g_object_id_uniform, ENEMY);
 
             for (size_t i = 0; i < aircraft_model.shapes.size(); i++) {
                 DrawVirtualObject(aircraft_model.shapes[i].name.c_str());
             }
         }
 
+        GpuTimers_Begin("checkpoints");
+
         //dedsenha os checkpoints
-        for (const auto &checkpoint_pos : g_Checkpoints)
+        for (const auto &checkpoint_pos : g_Game.checkpoints)
         {
+            if (isHiddenBehindMoon(camera_position_c, checkpoint_pos, checkpointCullRadius))
+                continue;
+
             glm::mat4 checkpoint_model = Matrix_Translate(checkpoint_pos.x, checkpoint_pos.y, checkpoint_pos.z)
                                     * Matrix_Scale(0.25f/15.0f, 0.25f/15.0f, 0.25f/15.0f);
 
-            glUniformMatrix4fv(g_model_uniform, 1 , GL_FALSE , glm::value_ptr(checkpoint_model));
-            glUniform1i(g_object_id_uniform, CHECKPOINT_SPHERE);
+            RenderStats_UniformMatrix4fv(g_model_uniform, 1 , GL_FALSE , glm::value_ptr(checkpoint_model));
+            RenderStats_Uniform1i(g_object_id_uniform, CHECKPOINT_SPHERE);
             DrawVirtualObject("the_sphere");
         }
 
-        // 1. Calcula a posição na Curva de Bézier.
-        glm::vec4 pos = evaluateBezier(g_Asteroid_P0, g_Asteroid_P1, g_Asteroid_P2, g_Asteroid_P3, g_Asteroid_t);
-
-        // desenha o asteroid com am ovimentação de bezier
-        model = Matrix_Translate(pos.x, pos.y, pos.z)
-                * Matrix_Scale(asteroidScale, asteroidScale, asteroidScale);
-
-        glUniformMatrix4fv(g_model_uniform, 1 , GL_FALSE , glm::value_ptr(model));
-        glUniform1i(g_object_id_uniform, ASTEROID);
-        DrawVirtualObject("10464_Asteroid_v1");
+        GpuTimers_Begin("moon");
 
         // ativa gouraud para a lua
         gouraud = true;
-        glUniform1i(g_gouraud_uniform, gouraud);
+        RenderStats_Uniform1i(g_gouraud_uniform, gouraud);
 
         // Desenhamos o plano do chão (lua)
         model = Matrix_Translate(moon_position.x, moon_position.y, moon_position.z) * Matrix_Scale(15.0f/60.0f, 15.0f/60.0f, 15.0f/60.0f);
-        glUniformMatrix4fv(g_model_uniform, 1 , GL_FALSE , glm::value_ptr(model));
-        glUniform1i(g_object_id_uniform, PLANE);
+        RenderStats_UniformMatrix4fv(g_model_uniform, 1 , GL_FALSE , glm::value_ptr(model));
+        RenderStats_Uniform1i(g_object_id_uniform, PLANE);
         DrawVirtualObject("the_sphere");
 
         // desativa gouraud
         gouraud = false;
-        glUniform1i(g_gouraud_uniform, gouraud);
-
-        // desenhando o HUD ("progress bar" de vida)
-        if (g_AircraftLife > 0 && !g_IsGameOver)
-        {
-            // Desativamos testes 3D (Z-buffer e Culling) para desenhar o HUD em 2D
-            glDisable(GL_DEPTH_TEST);
-            glDisable(GL_CULL_FACE);
-
-            // Matrizes Identidade (espaço NDC, fixo na tela)
-            glm::mat4 life_view = Matrix_Identity();
-            glm::mat4 life_projection = Matrix_Identity();
-            glm::mat4 life_model = Matrix_Identity();
-
-            glUniformMatrix4fv(g_view_uniform, 1, GL_FALSE, glm::value_ptr(life_view));
-            glUniformMatrix4fv(g_projection_uniform, 1, GL_FALSE, glm::value_ptr(life_projection));
+        RenderStats_Uniform1i(g_gouraud_uniform, gouraud);
 
-            float bar_width_max = 0.001f;     // Largura total em NDC
-            float bar_height = 0.0005f;       // Altura em NDC
-            float margin_x = 0.1f;         // Margem da borda direita
-            float margin_y = 0.1f;         // Margem da borda superior
+        GpuTimers_Begin("asteroids");
 
-            float bar_x_center = 1.0f - margin_x - (bar_width_max / 2.0f);
+        // 1. Calcula a posição na Curva de Bézier. Quando a curva recomeça
+        // no último passo, não interpolamos (o asteroide voltaria pela curva).
+        float asteroid_t = g_Game.asteroidT;
+        if (g_Game.asteroidT >= g_Game.asteroidTPrev)
+            asteroid_t = g_Game.asteroidTPrev + (g_Game.asteroidT - g_Game.asteroidTPrev) * alpha;
+        glm::vec4 pos = Sim_AsteroidBezierPosition(asteroid_t);
 
-            float bar_y_center = 1.0f - margin_y - (bar_height / 2.0f);
-
-            life_model = Matrix_Translate(bar_x_center, bar_y_center, 0.0f)
-                      * Matrix_Scale(bar_width_max, bar_height, 0.0f);
-
-            glUniformMatrix4fv(g_model_uniform, 1 , GL_FALSE , glm::value_ptr(life_model));
-            glUniform1i(g_object_id_uniform, HEALTH_BAR_BACKGROUND);
-            DrawVirtualObject("the_sphere");
-
-            float current_life_ratio = (float)g_AircraftLife / (float)MAX_LIFE;
-            float current_width = bar_width_max * current_life_ratio;
-
-            float x_offset_correction = (current_width - bar_width_max) / 2.0f;
-
-            life_model = Matrix_Translate(bar_x_center + x_offset_correction, bar_y_center, 0.0f)
-                      * Matrix_Scale(current_width, bar_height, 0.0f);
-
-            glUniformMatrix4fv(g_model_uniform, 1 , GL_FALSE , glm::value_ptr(life_model));
-            glUniform1i(g_object_id_uniform, HEALTH_BAR_FOREGROUND);
-            DrawVirtualObject("the_sphere");
-
-            // Voltamos às configurações 3D
-            glEnable(GL_CULL_FACE);
-            glEnable(GL_DEPTH_TEST);
+        // desenha o asteroid com am ovimentação de bezier
+        if (!isHiddenBehindMoon(camera_position_c, pos, asteroidCullRadius))
+        {
+            model = Matrix_Translate(pos.x, pos.y, pos.z)
+                    * Matrix_Scale(asteroidScale, asteroidScale, asteroidScale);
 
-            // Restauramos View e Projection para a câmera 3D
-            glUniformMatrix4fv(g_view_uniform, 1 , GL_FALSE , glm::value_ptr(view));
-            glUniformMatrix4fv(g_projection_uniform , 1 , GL_FALSE , glm::value_ptr(projection));
+            RenderStats_UniformMatrix4fv(g_model_uniform, 1 , GL_FALSE , glm::value_ptr(model));
+            RenderStats_Uniform1i(g_object_id_uniform, ASTEROID);
+            DrawVirtualObject("10464_Asteroid_v1");
         }
 
-
         // ativa gouraud para os asteroides aleatorios
         // OBS: O asteroid com curva de bezier nao tem gouraud
         gouraud = true;
-        glUniform1i(g_gouraud_uniform, gouraud);
-        glUniform1i(g_object_id_uniform, ASTEROID);
+        RenderStats_Uniform1i(g_gouraud_uniform, gouraud);
+        RenderStats_Uniform1i(g_object_id_uniform, ASTEROID);
 
         //desenha os asteroides aleatorios
-        for (const auto& randomPos : g_RandomAsteroids) {
+        for (size_t a = 0; a < g_Game.randomAsteroids.size(); ++a) {
+            glm::vec4 randomPos = g_Game.randomAsteroids.position(a);
+            if (isHiddenBehindMoon(camera_position_c, randomPos, asteroidCullRadius))
+                continue;
+
             model = Matrix_Translate(randomPos.x, randomPos.y, randomPos.z)
                   * Matrix_Scale(asteroidScale, asteroidScale, asteroidScale);
 
-            glUniformMatrix4fv(g_model_uniform, 1 , GL_FALSE , glm::value_ptr(model));
+            RenderStats_UniformMatrix4fv(g_model_uniform, 1 , GL_FALSE , glm::value_ptr(model));
             DrawVirtualObject("10464_Asteroid_v1");
         }
 
         gouraud = false;
-        glUniform1i(g_gouraud_uniform, gouraud);
+        RenderStats_Uniform1i(g_gouraud_uniform, gouraud);
+
+        GpuTimers_Begin("missiles");
 
         // desenha os misseis
-        for (const auto &missile : g_Missiles) {
-            if (!missile.isActive) continue;
+        const MissilePool& missiles = g_Game.missiles;
+        for (size_t m = 0; m < missiles.size(); ++m) {
+            glm::vec4 missile_pos = Sim_InterpolateOrbitPosition(missiles.prevPosition(m), missiles.position(m), alpha);
 
-            glm::vec4 missile_pos = missile.position;
+            if (isHiddenBehindMoon(camera_position_c, missile_pos, g_MissileCullRadius))
+                continue;
             glm::vec4 up_m = normalizedVec(missile_pos - moon_position);
-            glm::vec4 front_m = missile.forward;
+            glm::vec4 front_m = Sim_InterpolateDirection(missiles.prevForward(m), missiles.forward(m), alpha);
+            front_m = normalizedVec(front_m - dotproduct(front_m, up_m) * up_m);
             glm::vec4 right_m = normalizedVec(crossproduct(up_m, front_m));
 
             glm::mat4 rotation_align_missile = glm::mat4(1.0f);
@@ -794,8 +790,8 @@ int main(int argc, char* argv[])
                   * Matrix_Scale(0.1f, 0.1f, 0.1f)
                   * Matrix_Rotate_Y(M_PI);
 
-            glUniformMatrix4fv(g_model_uniform, 1 , GL_FALSE , glm::value_ptr(model));
-            glUniform1i(g_object_id_uniform, AIRCRAFT); // Usa textura da nave
+            RenderStats_UniformMatrix4fv(g_model_uniform, 1 , GL_FALSE , glm::value_ptr(model));
+            RenderStats_Uniform1i(g_object_id_uniform, AIRCRAFT); // Usa textura da nave
 
             for (size_t i = 0; i < aircraft_model.shapes.size(); i++) {
                 if (aircraft_model.shapes[i].name == "R-40TL") {
@@ -805,13 +801,51 @@ int main(int argc, char* argv[])
             }
         }
 
-        // guarda a posição passada da nave para o calculo de colisão
-        g_AircraftPosition_Prev = g_AircraftPosition;
+        // O céu é desenhado por último entre os objetos 3D, na profundidade
+        // máxima: fragmentos já cobertos pela lua ou pelas naves são
+        // descartados pelo teste de profundidade antes do fragment shader.
+        GpuTimers_Begin("skybox");
+        DrawSkybox(view, projection);
 
-        tprev = tnow;
+        // desenhando o HUD ("progress bar" de vida)
+        if (g_Game.aircraftLife > 0 && !g_Game.isGameOver)
+        {
+            float bar_width = 0.12f;     // Largura total em NDC
+            float bar_height = 0.06f;    // Altura em NDC
+            float margin_x = 0.04f;      // Margem da borda direita
+            float margin_y = 0.07f;      // Margem da borda superior
+
+            float current_life_ratio = (float)g_Game.aircraftLife / (float)MAX_LIFE;
+
+            HudRendering_Bar(1.0f - margin_x - bar_width, 1.0f - margin_y - bar_height,
+                             bar_width, bar_height, current_life_ratio,
+                             glm::vec4(0.3f, 0.3f, 0.3f, 1.0f),  // Fundo
+                             glm::vec4(0.1f, 0.8f, 0.1f, 1.0f)); // Vida atual
+        }
+
+        // Todas as primitivas 2D do quadro são desenhadas de uma só vez
+        GpuTimers_Begin("hud");
+        HudRendering_Flush();
+        GpuTimers_End();
 
         showText(window);
 
+        if (g_ShowPerformanceOverlay)
+        {
+            TextRendering_ShowFramesPerSecond(window);
+            TextRendering_ShowGpuTimers(window);
+        }
+
+        if (g_ShowRenderStats)
+            TextRendering_ShowRenderStats(window);
+
+        // Todo o texto do quadro é desenhado de uma só vez (uma chamada de
+        // desenho para os textos retidos e outra para os demais)
+        GpuTimers_Begin("text");
+        TextRendering_Flush();
+        GpuTimers_EndFrame();
+        RenderStats_EndFrame();
+
         // O framebuffer onde OpenGL executa as operações de renderização não
         // é o mesmo que está sendo mostrado para o usuário, caso contrário
         // seria possível ver artefatos conhecidos como "screen tearing". A
@@ -886,6 +920,156 @@ void LoadTextureImage(const char* filename)
     g_NumLoadedTextures += 1;
 }
 
+// Função que carrega uma imagem equiretangular (longitude x latitude) e a
+// converte, na CPU, para as seis faces de um cubemap. O cubemap é amostrado
+// pelo programa do céu (veja "shader_sky_fragment.glsl").
+void LoadCubemapFromEquirectangular(const char* filename)
+{
+    printf("Carregando cubemap \"%s\"... ", filename);
+
+    // Aqui não invertemos a imagem: a linha 0 corresponde ao "topo" do céu.
+    stbi_set_flip_vertically_on_load(false);
+    int width;
+    int height;
+    int channels;
+    unsigned char *data = stbi_load(filename, &width, &height, &channels, 3);
+
+    if ( data == NULL )
+    {
+        fprintf(stderr, "ERROR: Cannot open image file \"%s\".\n", filename);
+        std::exit(EXIT_FAILURE);
+    }
+
+    // Cada face cobre 90 graus, isto é, um quarto da largura da imagem.
+    int face_size = std::min(1024, width / 4);
+
+    printf("OK (%dx%d -> 6x%dx%d).\n", width, height, face_size, face_size);
+
+    GLuint texture_id;
+    GLuint sampler_id;
+    glGenTextures(1, &texture_id);
+    glGenSamplers(1, &sampler_id);
+
+    glSamplerParameteri(sampler_id, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glSamplerParameteri(sampler_id, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glSamplerParameteri(sampler_id, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+    glSamplerParameteri(sampler_id, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glSamplerParameteri(sampler_id, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0);
+    glPixelStorei(GL_UNPACK_SKIP_ROWS, 0);
+
+    GLuint textureunit = g_NumLoadedTextures;
+    glActiveTexture(GL_TEXTURE0 + textureunit);
+    glBindTexture(GL_TEXTURE_CUBE_MAP, texture_id);
+
+    std::vector<unsigned char> face(face_size * face_size * 3);
+
+    for (int f = 0; f < 6; ++f)
+    {
+        for (int j = 0; j < face_size; ++j)
+        {
+            for (int i = 0; i < face_size; ++i)
+            {
+                // Coordenadas (s,t) em [-1,1] do texel dentro da face
+                float sc = 2.0f * (i + 0.5f) / face_size - 1.0f;
+                float tc = 2.0f * (j + 0.5f) / face_size - 1.0f;
+
+                // Direção correspondente, seguindo a convenção de faces de
+                // cubemap da especificação OpenGL (+X, -X, +Y, -Y, +Z, -Z).
+                glm::vec3 d;
+                switch (f)
+                {
+                    case 0:  d = glm::vec3( 1.0f, -tc, -sc); break;
+                    case 1:  d = glm::vec3(-1.0f, -tc,  sc); break;
+                    case 2:  d = glm::vec3( sc,  1.0f,  tc); break;
+                    case 3:  d = glm::vec3( sc, -1.0f, -tc); break;
+                    case 4:  d = glm::vec3( sc, -tc,  1.0f); break;
+                    default: d = glm::vec3(-sc, -tc, -1.0f); break;
+                }
+                float len = std::sqrt(d.x*d.x + d.y*d.y + d.z*d.z);
+                d /= len;
+
+                // Longitude e latitude da direção, mapeadas para a imagem
+                float u = 0.5f + std::atan2(d.x, -d.z) / (2.0f * (float)M_PI);
+                float v = 0.5f - std::asin(d.y) / (float)M_PI;
+
+                // Amostragem bilinear da imagem equiretangular
+                float px = u * width - 0.5f;
+                float py = v * (height - 1);
+                int x0 = (int)std::floor(px);
+                int y0 = std::max(0, std::min(height - 1, (int)std::floor(py)));
+                int y1 = std::min(height - 1, y0 + 1);
+                float fx = px - x0;
+                float fy = std::max(0.0f, std::min(1.0f, py - y0));
+                int xa = ((x0 % width) + width) % width;
+                int xb = (xa + 1) % width;
+
+                for (int c = 0; c < 3; ++c)
+                {
+                    float top    = data[(y0*width + xa)*3 + c] * (1.0f - fx) + data[(y0*width + xb)*3 + c] * fx;
+                    float bottom = data[(y1*width + xa)*3 + c] * (1.0f - fx) + data[(y1*width + xb)*3 + c] * fx;
+                    face[(j*face_size + i)*3 + c] = (unsigned char)(top * (1.0f - fy) + bottom * fy + 0.5f);
+                }
+            }
+        }
+
+        glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + f, 0, GL_SRGB8, face_size, face_size, 0, GL_RGB, GL_UNSIGNED_BYTE, face.data());
+    }
+
+    glGenerateMipmap(GL_TEXTURE_CUBE_MAP);
+    glBindSampler(textureunit, sampler_id);
+
+    // Evita as "costuras" visíveis entre as faces do cubemap
+    glEnable(GL_TEXTURE_CUBE_MAP_SEAMLESS);
+
+    stbi_image_free(data);
+
+    // O sampler do programa do céu passa a usar a unidade em que o cubemap
+    // foi carregado (LoadShadersFromFiles() faz o mesmo ao recarregar)
+    g_SkyboxTextureUnit = textureunit;
+    if ( g_SkyProgramID != 0 )
+    {
+        glUseProgram(g_SkyProgramID);
+        glUniform1i(glGetUniformLocation(g_SkyProgramID, "SkyboxCubemap"), g_SkyboxTextureUnit);
+        glUseProgram(0);
+    }
+
+    g_NumLoadedTextures += 1;
+}
+
+// Desenha o céu como um único triângulo que cobre toda a tela. Deve ser
+// chamada após todos os objetos opacos, para que o teste de profundidade
+// descarte os fragmentos do céu escondidos por eles.
+void DrawSkybox(const glm::mat4& view, const glm::mat4& projection)
+{
+    // Removemos a translação da câmera: o céu está "no infinito".
+    glm::mat4 view_rotation = view;
+    view_rotation[3] = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+
+    glm::mat4 inverse_view_projection = glm::inverse(projection * view_rotation);
+
+    RenderStats_UseProgram(g_SkyProgramID);
+    RenderStats_UniformMatrix4fv(g_sky_inverse_view_projection_uniform, 1, GL_FALSE, glm::value_ptr(inverse_view_projection));
+
+    // O triângulo é gerado com profundidade 1.0. GL_LEQUAL faz com que ele
+    // passe somente onde nada foi desenhado, e não precisamos escrever no
+    // Z-buffer.
+    glDepthFunc(GL_LEQUAL);
+    glDepthMask(GL_FALSE);
+
+    RenderStats_BindVertexArray(g_SkyVertexArrayObjectID);
+    RenderStats_DrawArrays(GL_TRIANGLES, 0, 3);
+    RenderStats_BindVertexArray(0);
+
+    glDepthMask(GL_TRUE);
+    glDepthFunc(GL_LESS);
+
+    RenderStats_UseProgram(g_GpuProgramID);
+}
+
 // Função que desenha um objeto armazenado em g_VirtualScene. Veja definição
 // dos objetos na função BuildTrianglesAndAddToVirtualScene().
 void DrawVirtualObject(const char* object_name)
@@ -893,21 +1077,21 @@ void DrawVirtualObject(const char* object_name)
     // "Ligamos" o VAO. Informamos que queremos utilizar os atributos de
     // vértices apontados pelo VAO criado pela função BuildTrianglesAndAddToVirtualScene(). Veja
     // comentários detalhados dentro da definição de BuildTrianglesAndAddToVirtualScene().
-    glBindVertexArray(g_VirtualScene[object_name].vertex_array_object_id);
+    RenderStats_BindVertexArray(g_VirtualScene[object_name].vertex_array_object_id);
 
     // Setamos as variáveis "bbox_min" e "bbox_max" do fragment shader
     // com os parâmetros da axis-aligned bounding box (AABB) do modelo.
     glm::vec3 bbox_min = g_VirtualScene[object_name].bbox_min;
     glm::vec3 bbox_max = g_VirtualScene[object_name].bbox_max;
-    glUniform4f(g_bbox_min_uniform, bbox_min.x, bbox_min.y, bbox_min.z, 1.0f);
-    glUniform4f(g_bbox_max_uniform, bbox_max.x, bbox_max.y, bbox_max.z, 1.0f);
+    RenderStats_Uniform4f(g_bbox_min_uniform, bbox_min.x, bbox_min.y, bbox_min.z, 1.0f);
+    RenderStats_Uniform4f(g_bbox_max_uniform, bbox_max.x, bbox_max.y, bbox_max.z, 1.0f);
 
     // Pedimos para a GPU rasterizar os vértices dos eixos XYZ
     // apontados pelo VAO como linhas. Veja a definição de
     // g_VirtualScene[""] dentro da função BuildTrianglesAndAddToVirtualScene(), e veja
     // a documentação da função glDrawElements() em
     // http://docs.gl/gl3/glDrawElements.
-    glDrawElements(
+    RenderStats_DrawElements(
         g_VirtualScene[object_name].rendering_mode,
         g_VirtualScene[object_name].num_indices,
         GL_UNSIGNED_INT,
@@ -916,7 +1100,7 @@ void DrawVirtualObject(const char* object_name)
 
     // "Desligamos" o VAO, evitando assim que operações posteriores venham a
     // alterar o mesmo. Isso evita bugs.
-    glBindVertexArray(0);
+    RenderStats_BindVertexArray(0);
 }
 
 // Função que carrega os shaders de vértices e de fragmentos que serão
@@ -971,6 +1155,25 @@ void LoadShadersFromFiles()
     glUniform1i(glGetUniformLocation(g_GpuProgramID, "TextureImage3"), 3);
 
     glUseProgram(0);
+
+    // Programa de GPU do céu, desenhado separadamente. Veja DrawSkybox().
+    GLuint sky_vertex_shader_id = LoadShader_Vertex("../../src/shader_sky_vertex.glsl");
+    GLuint sky_fragment_shader_id = LoadShader_Fragment("../../src/shader_sky_fragment.glsl");
+
+    if ( g_SkyProgramID != 0 )
+        glDeleteProgram(g_SkyProgramID);
+
+    g_SkyProgramID = CreateGpuProgram(sky_vertex_shader_id, sky_fragment_shader_id);
+    g_sky_inverse_view_projection_uniform = glGetUniformLocation(g_SkyProgramID, "inverse_view_projection");
+
+    // Os shaders são carregados antes das texturas; nesse caso a unidade do
+    // cubemap é definida por LoadCubemapFromEquirectangular()
+    if ( g_SkyboxTextureUnit >= 0 )
+    {
+        glUseProgram(g_SkyProgramID);
+        glUniform1i(glGetUniformLocation(g_SkyProgramID, "SkyboxCubemap"), g_SkyboxTextureUnit);
+        glUseProgram(0);
+    }
 }
 
 // Função que pega a matriz M e guarda a mesma no topo da pilha
@@ -993,6 +1196,26 @@ void PopMatrix(glm::mat4& M)
     }
 }
 
+// Função que computa o raio de uma esfera, centrada na origem do modelo, que
+// envolve todos os vértices da peça "shape_name" de um ObjModel
+float ComputeShapeRadius(ObjModel* model, const char* shape_name)
+{
+    float radius = 0.0f;
+    for (size_t shape = 0; shape < model->shapes.size(); ++shape)
+    {
+        if (model->shapes[shape].name != shape_name)
+            continue;
+
+        const std::vector<tinyobj::index_t>& indices = model->shapes[shape].mesh.indices;
+        for (size_t i = 0; i < indices.size(); ++i)
+        {
+            const float* v = &model->attrib.vertices[3*indices[i].vertex_index];
+            radius = std::max(radius, std::sqrt(v[0]*v[0] + v[1]*v[1] + v[2]*v[2]));
+        }
+    }
+    return radius;
+}
+
 // Função que computa as normais de um ObjModel, caso elas não tenham sido
 // especificadas dentro do arquivo ".obj"
 void ComputeNormals(ObjModel* model)
@@ -1596,17 +1819,18 @@ void KeyCallback(GLFWwindow* window, int key, int scancode, int action, int mod)
     //   Se apertar tecla shift+Z então g_AngleZ -= delta;
 
     if (key == GLFW_KEY_R && action == GLFW_PRESS){
-        resetGame();
+        // A nova partida continua a sequência aleatória da anterior
+        Sim_Reset(g_Game, g_Game.rng);
     }
 
     //Lógica de Movimentação da Aeronave
     if(key == GLFW_KEY_W)
     {
         if (action == GLFW_PRESS)
-            isWPressed = true;
+            g_Input.forward = true;
 
         else if (action == GLFW_RELEASE)
-            isWPressed = false;
+            g_Input.forward = false;
 
         else if (action == GLFW_REPEAT)
             ;
@@ -1615,10 +1839,10 @@ void KeyCallback(GLFWwindow* window, int key, int scancode, int action, int mod)
     if(key == GLFW_KEY_A)
     {
         if (action == GLFW_PRESS)
-            isAPressed = true;
+            g_Input.left = true;
 
         else if (action == GLFW_RELEASE)
-            isAPressed = false;
+            g_Input.left = false;
 
         else if (action == GLFW_REPEAT)
             ;
@@ -1627,10 +1851,10 @@ void KeyCallback(GLFWwindow* window, int key, int scancode, int action, int mod)
     if(key == GLFW_KEY_D)
     {
         if (action == GLFW_PRESS)
-            isDPressed = true;
+            g_Input.right = true;
 
         else if (action == GLFW_RELEASE)
-            isDPressed = false;
+            g_Input.right = false;
 
         else if (action == GLFW_REPEAT)
             ;
@@ -1638,9 +1862,9 @@ void KeyCallback(GLFWwindow* window, int key, int scancode, int action, int mod)
 
     if(key == GLFW_KEY_I)
     {
-        if (action == GLFW_PRESS && !g_FreeWorld)
+        if (action == GLFW_PRESS && !g_Input.freeFlight)
             // Usuário apertou a tecla I, então começa o jogo, se apertar novamente pausa
-            isIPressed = !isIPressed;
+            g_Input.running = !g_Input.running;
     }
 
     if (key == GLFW_KEY_C && action == GLFW_PRESS)
@@ -1648,26 +1872,57 @@ void KeyCallback(GLFWwindow* window, int key, int scancode, int action, int mod)
         g_UseFirstPersonCamera = !g_UseFirstPersonCamera;
     }
 
-    if (key == GLFW_KEY_B && action == GLFW_PRESS && !isIPressed)
+    if (key == GLFW_KEY_B && action == GLFW_PRESS && !g_Input.running)
     {
-        g_FreeWorld = !g_FreeWorld;
+        g_Input.freeFlight = !g_Input.freeFlight;
     }
 
-    // logica de tiro da nave
+    // logica de tiro da nave: o míssil é disparado no próximo passo da
+    // simulação, se o tempo de recarga permitir
     if (key == GLFW_KEY_SPACE && action == GLFW_PRESS) {
-        float tnow = glfwGetTime();
-        if (tnow > g_PlayerShotTimer + shootColdownTimer && isIPressed && !g_IsGameOver) {
+        g_Input.fire = true;
+    }
 
-            g_PlayerShotTimer = tnow; // Resetar o temporizador
+    // F2 mostra/esconde o FPS e os tempos de GPU de cada etapa
+    if (key == GLFW_KEY_F2 && action == GLFW_PRESS)
+    {
+        g_ShowPerformanceOverlay = !g_ShowPerformanceOverlay;
+    }
 
-            glm::vec4 up_vec = normalizedVec(g_AircraftPosition - moon_position);
-            glm::vec4 front_vec = g_AircraftForward;
-            glm::vec4 right_vec = normalizedVec(crossproduct(up_vec, front_vec));
+    // F3 inicia/encerra a gravação dos tempos de GPU em um arquivo CSV
+    if (key == GLFW_KEY_F3 && action == GLFW_PRESS)
+    {
+        if (GpuTimers_IsRecordingCsv())
+        {
+            GpuTimers_StopCsv();
+            fprintf(stdout,"Tempos de GPU gravados em \"gpu_timers.csv\".\n");
+        }
+        else if (GpuTimers_StartCsv("gpu_timers.csv"))
+        {
+            fprintf(stdout,"Gravando tempos de GPU em \"gpu_timers.csv\"...\n");
+        }
+        fflush(stdout);
+    }
 
-            glm::vec4 missile_start_pos = g_AircraftPosition + front_vec * 0.5f + right_vec * -0.45f;
+    // F4 mostra/esconde os contadores de renderização do último quadro
+    if (key == GLFW_KEY_F4 && action == GLFW_PRESS)
+    {
+        g_ShowRenderStats = !g_ShowRenderStats;
+    }
 
-            fireMissile(missile_start_pos, front_vec, 0); // ownerId 0 = Nave
+    // F5 inicia/encerra o log dos contadores de renderização em um arquivo CSV
+    if (key == GLFW_KEY_F5 && action == GLFW_PRESS)
+    {
+        if (RenderStats_IsLogging())
+        {
+            RenderStats_StopLog();
+            fprintf(stdout,"Contadores de renderização gravados em \"render_stats.csv\".\n");
         }
+        else if (RenderStats_StartLog("render_stats.csv"))
+        {
+            fprintf(stdout,"Gravando contadores de renderização em \"render_stats.csv\"...\n");
+        }
+        fflush(stdout);
     }
 
     if (key == GLFW_KEY_R && action == GLFW_PRESS)
@@ -1800,6 +2055,7 @@ void TextRendering_ShowFramesPerSecond(GLFWwindow* window)
 
     if ( ellapsed_seconds > 1.0f )
     {
+        numchars = snprintf(buffer, 20, "%.2f fps", ellapsed_frames / ellapsed_seconds);
 
         old_seconds = seconds;
         ellapsed_frames = 0;
@@ -1811,6 +2067,62 @@ void TextRendering_ShowFramesPerSecond(GLFWwindow* window)
     TextRendering_PrintString(window, buffer, 1.0f-(numchars + 1)*charwidth, 1.0f-lineheight, 1.0f);
 }
 
+// Escrevemos na tela, abaixo do FPS, o tempo médio de GPU (em milissegundos)
+// de cada etapa da renderização. Veja "gputimers.cpp".
+void TextRendering_ShowGpuTimers(GLFWwindow* window)
+{
+    if ( !g_ShowInfoText )
+        return;
+
+    float lineheight = TextRendering_LineHeight(window);
+    float charwidth = TextRendering_CharWidth(window);
+
+    char buffer[40];
+    float y = 1.0f - 2*lineheight;
+    float total_ms = 0.0f;
+
+    for (size_t i = 0; i < GpuTimers_Count(); ++i)
+    {
+        int numchars = snprintf(buffer, 40, "%s %.3f ms", GpuTimers_Name(i), GpuTimers_AverageMs(i));
+        TextRendering_PrintString(window, buffer, 1.0f-(numchars + 1)*charwidth, y, 1.0f);
+        total_ms += GpuTimers_AverageMs(i);
+        y -= lineheight;
+    }
+
+    int numchars = snprintf(buffer, 40, "GPU %.3f ms%s", total_ms, GpuTimers_IsRecordingCsv() ? " [CSV]" : "");
+    TextRendering_PrintString(window, buffer, 1.0f-(numchars + 1)*charwidth, y, 1.0f);
+}
+
+// Escrevemos na tela, no canto inferior direito, os contadores de renderização
+// do último quadro completo. Veja "renderstats.cpp".
+void TextRendering_ShowRenderStats(GLFWwindow* window)
+{
+    if ( !g_ShowInfoText )
+        return;
+
+    const RenderStats& stats = RenderStats_LastFrame();
+
+    float lineheight = TextRendering_LineHeight(window);
+    float charwidth = TextRendering_CharWidth(window);
+
+    char lines[8][40];
+    int numlines = 0;
+    snprintf(lines[numlines++], 40, "draws %u", stats.draw_calls);
+    snprintf(lines[numlines++], 40, "tris %u", stats.triangles);
+    snprintf(lines[numlines++], 40, "uniforms %u", stats.uniform_uploads);
+    snprintf(lines[numlines++], 40, "programs %u vaos %u", stats.program_binds, stats.vao_binds);
+    snprintf(lines[numlines++], 40, "uploads %u (%.1f KB)", stats.buffer_uploads, stats.buffer_bytes / 1024.0);
+    snprintf(lines[numlines++], 40, "culled %u%s", stats.culled_objects, RenderStats_IsLogging() ? " [CSV]" : "");
+
+    float y = -1.0f + lineheight/10;
+    for (int i = numlines - 1; i >= 0; --i)
+    {
+        int numchars = (int)strlen(lines[i]);
+        TextRendering_PrintString(window, lines[i], 1.0f-(numchars + 1)*charwidth, y, 1.0f);
+        y += lineheight;
+    }
+}
+
 // Função para debugging: imprime no terminal todas informações de um modelo
 // geométrico carregado de um arquivo ".obj".
 // Veja: https://github.com/syoyo/tinyobjloader/blob/22883def8db9ef1f3ffb9b404318e7dd25fdbb51/loader_example.cc#L98
@@ -1980,377 +2292,28 @@ void PrintObjModelInfo(ObjModel* model)
   }
 }
 
-void moveAircraft(float tprev, float tnow, glm::vec4& aircraft_position) {
-    float delta_t = tnow - tprev;
-    float speed = 8.0f;
-    float turn_speed = 3.0f;
-    float fixedDistance = 16.0f;
-
-    // calcula os vetores de posição da nave
-    glm::vec4 currentPos = aircraft_position;
-
-    glm::vec4 up_vec = normalizedVec(currentPos - moon_position);
-
-    g_AircraftForward = normalizedVec(g_AircraftForward - dotproduct(g_AircraftForward, up_vec) * up_vec);
-
-    glm::vec4 right_vec = normalizedVec(crossproduct(up_vec, g_AircraftForward));
-
-    // logica de movimentação, baseado na distancia da lua, centro (posição da lua) e alinhando o obj da nave com a tangente da lua para sempre estar alinhado
-    if (isWPressed) {
-        float angle = speed * delta_t * 0.05f;
-
-
-        glm::mat4 rotMatrix = Matrix_Rotate(angle, right_vec);
-
-        glm::vec4 relativePosition = currentPos - moon_position;
-        relativePosition = rotMatrix * relativePosition;
-        currentPos = moon_position + relativePosition;
-
-        glm::vec4 fwd = g_AircraftForward;
-        g_AircraftForward = normalizedVec(rotMatrix * fwd);
-
-
-        // permite direita e esquerda, mas com velocidade reduzida
-        if (isAPressed || isDPressed) {
-            float angle = turn_speed * delta_t;
-            if (isDPressed) angle = -angle; // Inverte para Direita
-
-            // Rotação em torno do eixo UP (Normal da lua)
-            glm::mat4 rotMatrix = Matrix_Rotate(angle, up_vec);
-
-            glm::vec4 fwd = g_AircraftForward;
-            g_AircraftForward = normalizedVec(rotMatrix * fwd);
-        }
-    }
-
-    aircraft_position = currentPos;
-
-    glm::vec4 finalDir = normalizedVec(aircraft_position - moon_position);
-    aircraft_position = moon_position + (finalDir * fixedDistance);
-}
-
-// Função auxiliar para gerar float aleatório entre min e max
-float randomFloat(float min, float max) {
-    return min + static_cast <float> (rand()) / (static_cast <float> (RAND_MAX / (max - min)));
-}
-
-void InitEnemies() {
-    for(int i = 0; i < 3; i++) {
-        Enemy e;
-
-        // Posição aleatória na esfera
-        glm::vec4 randomPos = glm::vec4(randomFloat(-1.0f, 1.0f), randomFloat(-1.0f, 1.0f), randomFloat(-1.0f, 1.0f), 0.0f);
-        randomPos = normalizedVec(randomPos) * 16.0f;
-
-        e.position = randomPos + moon_position;
-
-        glm::vec4 up = normalizedVec(e.position - moon_position);
-        glm::vec4 randomDir = glm::vec4(randomFloat(-1.0f, 1.0f), randomFloat(-1.0f, 1.0f), randomFloat(-1.0f, 1.0f), 0.0f);
-
-        e.forward = normalizedVec(randomDir - dotproduct(randomDir, up) * up);
-
-        e.speed = 5.0f;
-        e.changeDirTimer = randomFloat(1.0f, 3.0f);
-
-        g_Enemies.push_back(e);
-    }
-}
-
-void moveEnemies(float tprev, float tnow) {
-    float delta_t = tnow - tprev;
-    float fixedDistance = 16.0f;
-
-
-    // mesma ideia do move aircraft, sempre levando em conta a posição da lua, a distancia do centro e tangente com a lua
-    // o inimigo sempre olha e busca chegar na posição do jogador, como uma caça
-    for (auto &enemy : g_Enemies) {
-        glm::vec4 currentPos = enemy.position;
-        glm::vec4 up_vec = normalizedVec(currentPos - moon_position);
-
-        // Garante que o forward é tangente à superfície
-        glm::vec4 projection_fwd = dotproduct(enemy.forward, up_vec) * up_vec;
-        enemy.forward = enemy.forward - projection_fwd;
-        enemy.forward = normalizedVec(enemy.forward);
-
-        // Vetor Desejado (Inimigo -> Jogador)
-        glm::vec4 vector_to_target = g_AircraftPosition - enemy.position;
-        vector_to_target.w = 0.0f;
-
-        // Projeta o vetor Desejado no plano tangente (impede que ele tente perfurar a Lua)
-        projection_fwd = dotproduct(vector_to_target, up_vec) * up_vec;
-        glm::vec4 desired_forward = vector_to_target - projection_fwd;
-        desired_forward = normalizedVec(desired_forward); // Vetor para onde o inimigo deve olhar
-
-        // Calcula o eixo e o ângulo para girar de enemy.forward para desired_forward
-        glm::vec4 rotation_axis = crossproduct(enemy.forward, desired_forward);
-
-        float dot_value = dotproduct(enemy.forward, desired_forward);
-
-        // Limita o valor do dotproduct para evitar erros de floating point com acos
-        if (dot_value > 1.0f) dot_value = 1.0f;
-        if (dot_value < -1.0f) dot_value = -1.0f;
-
-        float angle_to_turn = std::acos(dot_value);
-
-        // Limita a rotação para a taxa máxima de giro (para um movimento suave)
-        if (angle_to_turn > turnRate * delta_t) {
-            angle_to_turn = turnRate * delta_t;
-        }
-
-        // Aplica a rotação de Steering
-        glm::mat4 turnMatrix = Matrix_Rotate(angle_to_turn, rotation_axis);
-        enemy.forward = normalizedVec(turnMatrix * enemy.forward);
-
-
-        glm::vec4 right_vec = normalizedVec(crossproduct(up_vec, enemy.forward));
-
-        float angle_of_advance = enemySpeed * delta_t * 0.05f;
-        glm::mat4 moveMatrix = Matrix_Rotate(angle_of_advance, right_vec);
-
-        glm::vec4 relativePosition = currentPos - moon_position;
-        relativePosition = moveMatrix * relativePosition;
-
-        // Reprojetar na distância fixa de órbita
-        glm::vec4 finalDir = relativePosition; finalDir.w = 0.0f;
-        finalDir = normalizedVec(finalDir);
-        enemy.position = moon_position + (finalDir * fixedDistance);
-        enemy.position.w = 1.0f;
-
-        // Timer para o disparo do inimigo
-        static float enemy_shot_timer = 0.0f;
-        enemy_shot_timer += delta_t;
-
-        for (auto &enemy : g_Enemies) {
-            // Lógica de Disparo do Inimigo
-            if (enemy_shot_timer > enemyShotSpeed) {
-
-                glm::vec4 enemy_forward = enemy.forward;
-                glm::vec4 missile_start_pos = enemy.position + enemy_forward * 0.5f;
-
-                fireMissile(missile_start_pos, enemy_forward, 1); // ownerId 1
-            }
-        }
-
-        if (enemy_shot_timer > enemyShotSpeed) {
-            enemy_shot_timer = 0.0f; // Resetar timer após o loop
-        }
-    }
-}
-
-
-// Fórmula da Curva de Bézier Cúbica
-glm::vec4 evaluateBezier(glm::vec4 p0, glm::vec4 p1, glm::vec4 p2, glm::vec4 p3, float t) {
-    float u = 1.0f - t;
-    float tt = t * t;
-    float uu = u * u;
-    float uuu = uu * u;
-    float ttt = tt * t;
-
-    return (uuu * p0) + (3 * uu * t * p1) + (3 * u * tt * p2) + (ttt * p3);
-}
-
-// Função que testa as colisões
-void processCollisions() {
-    // =======================================================
-    // Colisão Nave vs. Inimigo (ESFERA-ESFERA)
-    // =======================================================
-
-    // Cria a Bounding Sphere da Nave
-    BoundingSphere aircraftSphere = getAircraftBoundingSphere(g_AircraftPosition);
-
-    // Iteramos sobre os inimigos
-    for (const auto &enemy : g_Enemies) {
-        for (int i = g_Enemies.size() - 1; i >= 0; --i) {
-            BoundingSphere enemySphere = getEnemyBoundingSphere(enemy.position);
-
-            if (checkSphereSphereCollision(aircraftSphere, enemySphere)) {
-                // Aplica dano (se o jogo ainda não acabou)
-                if (!g_IsGameOver) {
-                    g_AircraftLife -= 1;
-                    g_DamageTimer = damageDuration;
-                }
-
-                // Destrói o inimigo
-                std::swap(g_Enemies[i], g_Enemies.back());
-                g_Enemies.pop_back();
-            }
-        }
-    }
-
-    // =======================================================
-    // Coletar Checkpoints (RAIO-ESFERA)
-    // =======================================================
-
-    // A nave precisa ter se movido para que o raio de trajetória seja válido
-    if (g_AircraftPosition_Prev != g_AircraftPosition) {
-
-        // 1. Define o Raio (Linha de Movimento da Nave)
-        Ray trajectoryRay;
-        trajectoryRay.origin = g_AircraftPosition_Prev; // Posição anterior
-
-        glm::vec4 movement_vector = g_AircraftPosition - g_AircraftPosition_Prev;
-        movement_vector.w = 0.0f;
-
-        trajectoryRay.direction = normalizedVec(movement_vector);
-        float movement_distance = norm(movement_vector);
-
-        for (int i = g_Checkpoints.size() - 1; i >= 0; --i) {
-            glm::vec4 checkpoint_pos = g_Checkpoints[i];
-
-            BoundingSphere checkpointSphere = getCheckpointBoundingSphere(checkpoint_pos);
-
-            float t_hit; // Distância do ponto de colisão
-
-            if (checkRaySphereCollision(trajectoryRay, checkpointSphere, t_hit)) {
-
-                // Verifica se o ponto de intersecção (t_hit) ocorreu *dentro* do segmento de movimento
-                if (t_hit >= 0.0f && t_hit <= movement_distance) {
-                    // Remove o checkpoint coletado
-                    std::swap(g_Checkpoints[i], g_Checkpoints.back());
-                    g_Checkpoints.pop_back();
-
-                    // Recuperar vida ao pegar um checkpoint
-                    if (g_AircraftLife < MAX_LIFE) {
-                         g_AircraftLife++;
-                    }
-                }
-            }
-        }
-    }
-
-
-    bool collisionOccurred = false;
-
-    // =======================================================
-    // Colisão Nave vs. TODOS Asteroides (CILINDRO-ESFERA)
-    // =======================================================
-
-    // Itera de trás para frente para permitir a remoção segura
-    for (int i = g_RandomAsteroids.size() - 1; i >= 0; --i)
-    {
-        glm::vec4 asteroidPos = g_RandomAsteroids[i];
-        BoundingCylinder asteroidCylinder = getAsteroidBoundingCylinder(asteroidPos);
-
-        if (checkCylinderSphereCollision(asteroidCylinder, aircraftSphere)) {
-            if (!g_IsGameOver && !collisionOccurred) {
-                g_AircraftLife -= 1;
-                collisionOccurred = true;
-
-                g_DamageTimer = damageDuration;
-            }
-            std::swap(g_RandomAsteroids[i], g_RandomAsteroids.back());
-            g_RandomAsteroids.pop_back();
-        }
-    }
-
-    // Itera de trás para frente para permitir a remoção segura dos mísseis
-    for (int i = g_Missiles.size() - 1; i >= 0; --i) {
-        Missile &missile = g_Missiles[i];
-
-        if (!missile.isActive) continue;
-
-        BoundingSphere missileSphere = {missile.position, missileRadius};
-
-        bool hit = false;
-
-        // =======================================================
-        // Colisão Nave/Inimigo (Missil vs. Nave/Inimigo)
-        // =======================================================
-
-        if (missile.ownerId == 0) { // Míssil da Nave -> Colide com Inimigos
-            for (int j = g_Enemies.size() - 1; j >= 0; --j) {
-                Enemy &enemy = g_Enemies[j];
-                BoundingSphere enemySphere = getEnemyBoundingSphere(enemy.position);
-
-                if (checkSphereSphereCollision(missileSphere, enemySphere)) {
-                    // Destrói o inimigo
-                    std::swap(g_Enemies[j], g_Enemies.back());
-                    g_Enemies.pop_back();
-                    hit = true;
-                    break;
-                }
-            }
-        } else { // Míssil do Inimigo -> Colide com a Nave
-            BoundingSphere aircraftSphere = getAircraftBoundingSphere(g_AircraftPosition);
-            if (checkSphereSphereCollision(missileSphere, aircraftSphere)) {
-                // Aplica dano (se o jogo ainda não acabou)
-                if (!g_IsGameOver) {
-                    g_AircraftLife -= 1;
-
-                    g_DamageTimer = damageDuration;
-                }
-                hit = true;
-            }
-        }
-
-        // =======================================================
-        // Colisão Missil vs. Asteroides Aleatórios (Esfera vs. Cilindro)
-        // =======================================================
-
-        // Itera sobre os asteroides aleatórios (g_RandomAsteroids)
-        for (int j = g_RandomAsteroids.size() - 1; j >= 0; --j)
-        {
-            glm::vec4 asteroidPos = g_RandomAsteroids[j];
-            BoundingCylinder asteroidCylinder = getAsteroidBoundingCylinder(asteroidPos);
-
-            if (checkCylinderSphereCollision(asteroidCylinder, missileSphere)) {
-                std::swap(g_RandomAsteroids[j], g_RandomAsteroids.back());
-                g_RandomAsteroids.pop_back();
-
-                hit = true;
-                break;
-            }
-        }
+// Testa se a esfera envolvente de uma entidade está inteiramente escondida
+// atrás da lua, vista a partir da câmera. Usado para não desenhar entidades do
+// outro lado da órbita.
+bool isHiddenBehindMoon(const glm::vec4& camera_position, const glm::vec4& center, float radius) {
+    // Na projeção ortográfica os raios de visão são paralelos e o teste de
+    // oclusão a partir de um ponto não é válido.
+    if (!g_UsePerspectiveProjection)
+        return false;
 
-        if (hit) {
-            missile.isActive = false;
-            std::swap(g_Missiles[i], g_Missiles.back());
-            g_Missiles.pop_back();
-        }
-    }
-}
+    BoundingSphere moonSphere = getMoonOccluderSphere(moon_position);
+    BoundingSphere entitySphere = {center, radius};
 
-glm::vec4 normalizedVec(glm::vec4 v) {
-    float n = norm(v);
-    v = v / n;
-    v.w = 0.0f;
+    if (!checkSphereOccludedBySphere(camera_position, moonSphere, entitySphere))
+        return false;
 
-    return v;
-}
-
-// função que testa se o jogo acabou
-bool isGameOver() {
-    if (g_AircraftLife <= 0) {
-        g_IsGameOver = true;
-        return true;
-    }
-
-    if (g_Checkpoints.empty())
-    {
-        g_IsGameOver = true;
-        return true;
-    }
-
-    return false;
-}
-
-// reseta o jogo
-void resetGame() {
-    g_AircraftLife = 3;
-    g_IsGameOver = false;
-    g_Enemies.clear();
-    g_AircraftPosition = glm::vec4(0.0f, 0.0f, 16.0f, 1.0f);
-    g_AircraftPosition_Prev = g_AircraftPosition;
-    g_AircraftForward = glm::vec4(1.0f, 0.0f, 0.0f, 0.0f);
-    InitEnemies();
-    initCheckpoints();
-    initRandomAsteroids();
-    g_DamageTimer = 0.0f;
-    g_Asteroid_t = 0.0f;
-    g_Missiles.clear();
+    RenderStats_CountCulled();
+    return true;
 }
 
 // função exlusiva para adicionar as orientações e feedbacks na tela
+// Todas as linhas usam texto retido: só "Vida" e "Checkpoints Faltantes" mudam,
+// e somente quando ocorre algum evento no jogo.
 void showText(GLFWwindow* window){
     float pad = TextRendering_LineHeight(window);
     char buffer[80];
@@ -2360,151 +2323,53 @@ void showText(GLFWwindow* window){
 
     float est_width = 15.0f * TextRendering_CharWidth(window);
 
-    if (g_AircraftLife <= 0) {
+    if (g_Game.aircraftLife <= 0) {
         float current_y = -1.0f + margin_y_top;
 
-        TextRendering_PrintString(window, "GAME OVER! (Pressione ESC para sair)", -1.0f + margin_x, current_y, 1.0f);
+        TextRendering_PrintStringRetained(window, "GAME OVER! (Pressione ESC para sair)", -1.0f + margin_x, current_y, 1.0f);
         current_y += pad;
 
-        TextRendering_PrintString(window, "Pressione R para reiniciar", -1.0f + margin_x, current_y, 1.0f);
+        TextRendering_PrintStringRetained(window, "Pressione R para reiniciar", -1.0f + margin_x, current_y, 1.0f);
         current_y += pad;
-    } else if (g_Checkpoints.empty()) {
+    } else if (g_Game.checkpoints.empty()) {
         float current_y = -1.0f + margin_y_top;
 
-        TextRendering_PrintString(window, "PARABENS! VOCE VENCEU! (Pressione ESC para sair)", -1.0f + margin_x, current_y, 1.0f);
+        TextRendering_PrintStringRetained(window, "PARABENS! VOCE VENCEU! (Pressione ESC para sair)", -1.0f + margin_x, current_y, 1.0f);
         current_y += pad;
 
-        TextRendering_PrintString(window, "Pressione R para reiniciar", -1.0f + margin_x, current_y, 1.0f);
+        TextRendering_PrintStringRetained(window, "Pressione R para reiniciar", -1.0f + margin_x, current_y, 1.0f);
         current_y += pad;
-    } else if (!g_IsGameOver) {
-        snprintf(buffer, 80, "Vida: %d", g_AircraftLife);
+    } else if (!g_Game.isGameOver) {
+        snprintf(buffer, 80, "Vida: %d", g_Game.aircraftLife);
 
-        TextRendering_PrintString(window, buffer, 1.0f - margin_x - est_width, 1.0f - margin_y_top, 1.0f);
+        TextRendering_PrintStringRetained(window, buffer, 1.0f - margin_x - est_width, 1.0f - margin_y_top, 1.0f);
         float current_y = -1.0f + margin_y_top;
 
-        TextRendering_PrintString(window, "Pressione ESC para sair", -1.0f + margin_x, current_y, 1.0f);
+        TextRendering_PrintStringRetained(window, "Pressione ESC para sair", -1.0f + margin_x, current_y, 1.0f);
         current_y += pad;
 
-        TextRendering_PrintString(window, "C para alternar câmera livre", -1.0f + margin_x, current_y, 1.0f);
+        TextRendering_PrintStringRetained(window, "C para alternar câmera livre", -1.0f + margin_x, current_y, 1.0f);
         current_y += pad;
 
-        TextRendering_PrintString(window, "R para reiniciar o jogo", -1.0f + margin_x, current_y, 1.0f);
+        TextRendering_PrintStringRetained(window, "R para reiniciar o jogo", -1.0f + margin_x, current_y, 1.0f);
         current_y += pad;
 
-        TextRendering_PrintString(window, "Space para atirar", -1.0f + margin_x, current_y, 1.0f);
+        TextRendering_PrintStringRetained(window, "Space para atirar", -1.0f + margin_x, current_y, 1.0f);
         current_y += pad;
 
-        TextRendering_PrintString(window, "Use W,A,D para mover a aeronave", -1.0f + margin_x, current_y, 1.0f);
+        TextRendering_PrintStringRetained(window, "Use W,A,D para mover a aeronave", -1.0f + margin_x, current_y, 1.0f);
         current_y += pad;
 
-        TextRendering_PrintString(window, "Use o mouse para olhar ao redor (camera livre)", -1.0f + margin_x, current_y, 1.0f);
+        TextRendering_PrintStringRetained(window, "Use o mouse para olhar ao redor (camera livre)", -1.0f + margin_x, current_y, 1.0f);
         current_y += pad;
 
-        TextRendering_PrintString(window, "Pressione B para voo livre (desmonstração)", -1.0f + margin_x, current_y, 1.0f);
+        TextRendering_PrintStringRetained(window, "Pressione B para voo livre (desmonstração)", -1.0f + margin_x, current_y, 1.0f);
         current_y += pad;
 
-        TextRendering_PrintString(window, "Pressione I para iniciar/pausar o jogo", -1.0f + margin_x, current_y, 1.0f);
+        TextRendering_PrintStringRetained(window, "Pressione I para iniciar/pausar o jogo", -1.0f + margin_x, current_y, 1.0f);
         current_y += pad;
 
-        snprintf(buffer, 80, "Checkpoints Faltantes: %llu", g_Checkpoints.size());
-        TextRendering_PrintString(window, buffer, -1.0f + margin_x, 1.0f - margin_y_top, 1.0f);
-    }
-}
-
-// inicia os checkpoints no jogo
-void initCheckpoints() {
-    g_Checkpoints.clear();
-
-    float orbit_distance = 16.0f;
-    glm::vec4 center = moon_position;
-
-    g_Checkpoints.push_back(center + glm::vec4(orbit_distance, 0.0f, 0.0f, 1.0f));
-    g_Checkpoints.push_back(center + glm::vec4(-orbit_distance, 0.0f, 0.0f, 1.0f));
-    g_Checkpoints.push_back(center + glm::vec4(0.0f, orbit_distance, 0.0f, 1.0f));
-    g_Checkpoints.push_back(center + glm::vec4(0.0f, -orbit_distance, 0.0f, 1.0f));
-    g_Checkpoints.push_back(center + glm::vec4(0.0f, 0.0f, -orbit_distance, 1.0f));
-}
-
-// Função que inicializa asteroides em posições aleatórias na órbita
-void initRandomAsteroids() {
-    g_RandomAsteroids.clear();
-    float orbit_distance = 16.0f;
-    glm::vec4 center = moon_position;
-
-    for (int i = 0; i < numRandomAsteroids; ++i) {
-        glm::vec4 randomDir = glm::vec4(
-            randomFloat(-1.0f, 1.0f),
-            randomFloat(-1.0f, 1.0f),
-            randomFloat(-1.0f, 1.0f),
-            0.0f
-        );
-        randomDir = normalizedVec(randomDir);
-
-        glm::vec4 asteroidPos = center + randomDir * orbit_distance;
-        asteroidPos.w = 1.0f;
-
-        g_RandomAsteroids.push_back(asteroidPos);
-    }
-}
-
-
-// função de tiro do missil
-void fireMissile(const glm::vec4& startPos, const glm::vec4& direction, int ownerId) {
-    Missile m;
-    m.position = startPos;
-    m.forward = direction;
-    m.forward.w = 0.0f;
-    m.speed = missileSpeed;
-    m.fixedDistance = 16.0f;
-    m.isActive = true;
-    m.ownerId = ownerId;
-    m.lifeTime = missileLifespan;
-
-    g_Missiles.push_back(m);
-}
-
-// atualiza a movimentação do missil
-void updateMissiles(float tprev, float tnow) {
-    float delta_t = tnow - tprev;
-    float fixedDistance = 16.0f;
-
-    for (auto it = g_Missiles.begin(); it != g_Missiles.end();) {
-        Missile &m = *it;
-
-        if (!m.isActive) {
-            it = g_Missiles.erase(it);
-            continue;
-        }
-
-        m.lifeTime -= delta_t;
-        if (m.lifeTime <= 0.0f) {
-            m.isActive = false;
-            it = g_Missiles.erase(it);
-            continue;
-        }
-
-        glm::vec4 currentPos = m.position;
-        glm::vec4 up_vec = normalizedVec(currentPos - moon_position);
-
-        // O míssil avança na direção 'forward'
-        glm::vec4 right_vec = normalizedVec(crossproduct(up_vec, m.forward));
-
-        // Angulo de avanço na esfera (usando o vetor UP e o vetor RIGHT)
-        float angle_of_advance = m.speed * delta_t * 0.05f;
-        glm::mat4 moveMatrix = Matrix_Rotate(angle_of_advance, right_vec);
-
-        glm::vec4 relativePosition = currentPos - moon_position;
-        relativePosition = moveMatrix * relativePosition;
-
-        // Reprojetar na distância fixa de órbita
-        glm::vec4 finalDir = relativePosition; finalDir.w = 0.0f;
-        finalDir = normalizedVec(finalDir);
-        m.position = moon_position + (finalDir * fixedDistance);
-        m.position.w = 1.0f;
-
-        // A direção FORWARD também precisa ser girada para acompanhar a curva.
-        m.forward = normalizedVec(moveMatrix * m.forward);
-
-        it++;
+        snprintf(buffer, 80, "Checkpoints Faltantes: %llu", g_Game.checkpoints.size());
+        TextRendering_PrintStringRetained(window, buffer, -1.0f + margin_x, 1.0f - margin_y_top, 1.0f);
     }
 }
@@ -0,0 +1,146 @@
+// Triângulos de malhas para colisões precisas. Veja "meshcollider.h".
+#include <cmath>
+#include <algorithm>
+
+#include <glm/geometric.hpp>
+
+#include "meshcollider.h"
+#include "collisions.h"
+
+// Leva o ponto p do referencial da cena para o do "frame" (a inversa de uma
+// rotação é a transposta)
+static glm::vec4 MeshCollider_ToLocal(const glm::mat4& frame, const glm::vec4& p)
+{
+    glm::vec4 d = p - frame[3];
+    d.w = 0.0f;
+    return glm::vec4(glm::dot(d, frame[0]), glm::dot(d, frame[1]), glm::dot(d, frame[2]), 1.0f);
+}
+
+// Vértice v (0, 1 ou 2) do triângulo k da parte
+static glm::vec4 MeshCollider_Vertex(const MeshColliderPart& part, unsigned int k, int v)
+{
+    const float* p = &part.triangles[9 * k + 3 * v];
+    return glm::vec4(p[0], p[1], p[2], 1.0f);
+}
+
+void MeshCollider_AddPart(MeshCollider& mesh, const char* name, const float* vertices,
+                          const unsigned int* indices, size_t n, const glm::mat4& transform)
+{
+    std::vector<float> triangles;
+    std::vector<BvhBox> boxes;
+    triangles.reserve(9 * n);
+    boxes.reserve(n);
+
+    for (size_t k = 0; k < n; ++k) {
+        glm::vec4 p[3];
+        for (int v = 0; v < 3; ++v) {
+            const float* vertex = &vertices[3 * indices[3 * k + v]];
+            p[v] = transform * glm::vec4(vertex[0], vertex[1], vertex[2], 1.0f);
+        }
+
+        glm::vec3 normal = glm::cross(glm::vec3(p[1] - p[0]), glm::vec3(p[2] - p[0]));
+        if (glm::dot(normal, normal) == 0.0f)
+            continue;
+
+        BvhBox box;
+        for (int a = 0; a < 3; ++a) {
+            box.min[a] = std::min(p[0][a], std::min(p[1][a], p[2][a]));
+            box.max[a] = std::max(p[0][a], std::max(p[1][a], p[2][a]));
+        }
+        boxes.push_back(box);
+        for (int v = 0; v < 3; ++v) {
+            triangles.push_back(p[v].x);
+            triangles.push_back(p[v].y);
+            triangles.push_back(p[v].z);
+        }
+    }
+
+    if (boxes.empty())
+        return;
+
+    mesh.parts.push_back(MeshColliderPart());
+    MeshColliderPart& part = mesh.parts.back();
+    part.name = name ? name : "";
+    Bvh_Build(part.bvh, boxes.data(), boxes.size());
+
+    // Guarda os triângulos na ordem das folhas
+    std::vector<unsigned int> order;
+    Bvh_RenumberItems(part.bvh, order);
+    part.triangles.resize(triangles.size());
+    for (size_t k = 0; k < order.size(); ++k)
+        std::copy(&triangles[9 * order[k]], &triangles[9 * order[k]] + 9, &part.triangles[9 * k]);
+
+    // A caixa de cada parte é a da raiz da sua BVH
+    std::vector<BvhBox> part_boxes(mesh.parts.size());
+    for (size_t p = 0; p < mesh.parts.size(); ++p)
+        part_boxes[p] = mesh.parts[p].bvh.nodes[0].box;
+    Bvh_Build(mesh.partBvh, part_boxes.data(), part_boxes.size());
+}
+
+size_t MeshCollider_TriangleCount(const MeshCollider& mesh)
+{
+    size_t count = 0;
+    for (size_t p = 0; p < mesh.parts.size(); ++p)
+        count += mesh.parts[p].triangles.size() / 9;
+    return count;
+}
+
+bool MeshCollider_OverlapSphere(const MeshCollider& mesh, const glm::mat4& frame,
+                                const glm::vec4& center, float radius)
+{
+    BoundingSphere sphere = { MeshCollider_ToLocal(frame, center), radius };
+    bool hit = false;
+
+    // Depois do primeiro contato, a descida pelas árvores para sem visitar
+    // mais nenhum nó
+    auto overlaps = [&](const BvhBox& box) { return !hit && Bvh_BoxOverlapsSphere(box, sphere.center, radius); };
+
+    Bvh_Traverse(mesh.partBvh, overlaps, [&](unsigned int p) {
+        const MeshColliderPart& part = mesh.parts[p];
+        Bvh_Traverse(part.bvh, overlaps, [&](unsigned int k) {
+            if (!hit && checkTriangleSphereCollision(MeshCollider_Vertex(part, k, 0), MeshCollider_Vertex(part, k, 1),
+                                                     MeshCollider_Vertex(part, k, 2), sphere))
+                hit = true;
+        });
+    });
+    return hit;
+}
+
+bool MeshCollider_Segment(const MeshCollider& mesh, const glm::mat4& frame,
+                          const glm::vec4& p0, const glm::vec4& p1, float& t_out, int* part_out)
+{
+    glm::vec4 a = MeshCollider_ToLocal(frame, p0);
+    glm::vec4 b = MeshCollider_ToLocal(frame, p1);
+    Ray ray = { a, b - a };
+
+    // O segmento consultado termina no contato mais próximo já encontrado,
+    // então os nós depois dele são descartados
+    float best = 1.0f;
+    int best_part = -1;
+    float origin[3] = { a.x, a.y, a.z };
+
+    auto overlaps = [&](const BvhBox& box) {
+        float d[3] = { best * ray.direction.x, best * ray.direction.y, best * ray.direction.z };
+        return Bvh_BoxOverlapsSegment(box, origin, d, 0.0f);
+    };
+
+    Bvh_Traverse(mesh.partBvh, overlaps, [&](unsigned int p) {
+        const MeshColliderPart& part = mesh.parts[p];
+        Bvh_Traverse(part.bvh, overlaps, [&](unsigned int k) {
+            float t;
+            if (checkRayTriangleCollision(ray, MeshCollider_Vertex(part, k, 0), MeshCollider_Vertex(part, k, 1),
+                                          MeshCollider_Vertex(part, k, 2), t) && t <= best) {
+                best = t;
+                best_part = (int)p;
+            }
+        });
+    });
+
+    if (best_part < 0)
+        return false;
+
+    t_out = best;
+    if (part_out)
+        *part_out = best_part;
+    return true;
+}
@@ -0,0 +1,267 @@
+// Movimento sobre a órbita em forma fechada. Veja "orbitmotion.h".
+#include <cmath>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define ORBIT_USE_SSE
+#include <xmmintrin.h>
+#endif
+
+#include "orbitmotion.h"
+
+// Passo de um corpo. A versão SSE abaixo faz exatamente as mesmas operações,
+// então o resultado não depende de o corpo cair em um bloco de 4 ou no resto.
+static inline void Orbit_AdvanceScalar(float& x, float& y, float& z, float& fx, float& fy, float& fz,
+                                       float cx, float cy, float cz, float radius, float c, float s)
+{
+    // Direção unitária do centro até o corpo
+    float px = x - cx;
+    float py = y - cy;
+    float pz = z - cz;
+    float inv_p = 1.0f / std::sqrt(px*px + py*py + pz*pz);
+    px *= inv_p; py *= inv_p; pz *= inv_p;
+
+    // Direção de voo projetada no plano tangente e normalizada
+    float d = fx*px + fy*py + fz*pz;
+    float tx = fx - d*px;
+    float ty = fy - d*py;
+    float tz = fz - d*pz;
+    float inv_t = 1.0f / std::sqrt(tx*tx + ty*ty + tz*tz);
+    tx *= inv_t; ty *= inv_t; tz *= inv_t;
+
+    x = cx + radius * (px*c + tx*s);
+    y = cy + radius * (py*c + ty*s);
+    z = cz + radius * (pz*c + tz*s);
+    fx = tx*c - px*s;
+    fy = ty*c - py*s;
+    fz = tz*c - pz*s;
+}
+
+void Orbit_Advance(float* x, float* y, float* z, float* fx, float* fy, float* fz, size_t n,
+                   const glm::vec4& center, float radius, float angle)
+{
+    float c = std::cos(angle);
+    float s = std::sin(angle);
+
+    size_t i = 0;
+
+#ifdef ORBIT_USE_SSE
+    __m128 vcx = _mm_set1_ps(center.x);
+    __m128 vcy = _mm_set1_ps(center.y);
+    __m128 vcz = _mm_set1_ps(center.z);
+    __m128 vr  = _mm_set1_ps(radius);
+    __m128 vc  = _mm_set1_ps(c);
+    __m128 vs  = _mm_set1_ps(s);
+    __m128 one = _mm_set1_ps(1.0f);
+
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128 px = _mm_sub_ps(_mm_loadu_ps(x + i), vcx);
+        __m128 py = _mm_sub_ps(_mm_loadu_ps(y + i), vcy);
+        __m128 pz = _mm_sub_ps(_mm_loadu_ps(z + i), vcz);
+        __m128 len2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(px, px), _mm_mul_ps(py, py)), _mm_mul_ps(pz, pz));
+        __m128 inv_p = _mm_div_ps(one, _mm_sqrt_ps(len2));
+        px = _mm_mul_ps(px, inv_p);
+        py = _mm_mul_ps(py, inv_p);
+        pz = _mm_mul_ps(pz, inv_p);
+
+        __m128 fxv = _mm_loadu_ps(fx + i);
+        __m128 fyv = _mm_loadu_ps(fy + i);
+        __m128 fzv = _mm_loadu_ps(fz + i);
+        __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(fxv, px), _mm_mul_ps(fyv, py)), _mm_mul_ps(fzv, pz));
+        __m128 tx = _mm_sub_ps(fxv, _mm_mul_ps(d, px));
+        __m128 ty = _mm_sub_ps(fyv, _mm_mul_ps(d, py));
+        __m128 tz = _mm_sub_ps(fzv, _mm_mul_ps(d, pz));
+        __m128 tlen2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(tx, tx), _mm_mul_ps(ty, ty)), _mm_mul_ps(tz, tz));
+        __m128 inv_t = _mm_div_ps(one, _mm_sqrt_ps(tlen2));
+        tx = _mm_mul_ps(tx, inv_t);
+        ty = _mm_mul_ps(ty, inv_t);
+        tz = _mm_mul_ps(tz, inv_t);
+
+        _mm_storeu_ps(x + i, _mm_add_ps(vcx, _mm_mul_ps(vr, _mm_add_ps(_mm_mul_ps(px, vc), _mm_mul_ps(tx, vs)))));
+        _mm_storeu_ps(y + i, _mm_add_ps(vcy, _mm_mul_ps(vr, _mm_add_ps(_mm_mul_ps(py, vc), _mm_mul_ps(ty, vs)))));
+        _mm_storeu_ps(z + i, _mm_add_ps(vcz, _mm_mul_ps(vr, _mm_add_ps(_mm_mul_ps(pz, vc), _mm_mul_ps(tz, vs)))));
+        _mm_storeu_ps(fx + i, _mm_sub_ps(_mm_mul_ps(tx, vc), _mm_mul_ps(px, vs)));
+        _mm_storeu_ps(fy + i, _mm_sub_ps(_mm_mul_ps(ty, vc), _mm_mul_ps(py, vs)));
+        _mm_storeu_ps(fz + i, _mm_sub_ps(_mm_mul_ps(tz, vc), _mm_mul_ps(pz, vs)));
+    }
+#endif
+
+    for (; i < n; ++i)
+        Orbit_AdvanceScalar(x[i], y[i], z[i], fx[i], fy[i], fz[i],
+                            center.x, center.y, center.z, radius, c, s);
+}
+
+void Orbit_AdvanceOne(glm::vec4& position, glm::vec4& forward,
+                      const glm::vec4& center, float radius, float angle)
+{
+    Orbit_AdvanceScalar(position.x, position.y, position.z, forward.x, forward.y, forward.z,
+                        center.x, center.y, center.z, radius, std::cos(angle), std::sin(angle));
+    position.w = 1.0f;
+    forward.w = 0.0f;
+}
+
+// Limite abaixo do qual um vetor projetado no plano tangente é considerado
+// nulo (alvo exatamente acima/abaixo, ou exatamente atrás)
+static const float steerEpsilon = 1e-12f;
+
+#ifdef ORBIT_USE_SSE
+
+// 1/sqrt(v): aproximação de _mm_rsqrt_ps (12 bits) com um passo de Newton-Raphson
+static inline __m128 Orbit_InvSqrt(__m128 v)
+{
+    __m128 r = _mm_rsqrt_ps(v);
+    __m128 half_v_rr = _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(0.5f), v), _mm_mul_ps(r, r));
+    return _mm_mul_ps(r, _mm_sub_ps(_mm_set1_ps(1.5f), half_v_rr));
+}
+
+// Seleciona a onde mask é verdadeira, senão b
+static inline __m128 Orbit_Select(__m128 mask, __m128 a, __m128 b)
+{
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+// Steering de 4 corpos consecutivos
+static inline void Orbit_SteerBlock(const float* x, const float* y, const float* z, float* fx, float* fy, float* fz,
+                                    const glm::vec4& target, const glm::vec4& center, float cos_max, float sin_max)
+{
+    __m128 eps = _mm_set1_ps(steerEpsilon);
+
+    // Direção unitária do centro até o corpo (vetor "up")
+    __m128 x4 = _mm_loadu_ps(x), y4 = _mm_loadu_ps(y), z4 = _mm_loadu_ps(z);
+    __m128 px = _mm_sub_ps(x4, _mm_set1_ps(center.x));
+    __m128 py = _mm_sub_ps(y4, _mm_set1_ps(center.y));
+    __m128 pz = _mm_sub_ps(z4, _mm_set1_ps(center.z));
+    __m128 inv = Orbit_InvSqrt(_mm_add_ps(_mm_add_ps(_mm_mul_ps(px, px), _mm_mul_ps(py, py)), _mm_mul_ps(pz, pz)));
+    px = _mm_mul_ps(px, inv); py = _mm_mul_ps(py, inv); pz = _mm_mul_ps(pz, inv);
+
+    // Direção de voo atual, tangente
+    __m128 f_x = _mm_loadu_ps(fx), f_y = _mm_loadu_ps(fy), f_z = _mm_loadu_ps(fz);
+    __m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(f_x, px), _mm_mul_ps(f_y, py)), _mm_mul_ps(f_z, pz));
+    f_x = _mm_sub_ps(f_x, _mm_mul_ps(dot, px));
+    f_y = _mm_sub_ps(f_y, _mm_mul_ps(dot, py));
+    f_z = _mm_sub_ps(f_z, _mm_mul_ps(dot, pz));
+    inv = Orbit_InvSqrt(_mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(f_x, f_x), _mm_mul_ps(f_y, f_y)), _mm_mul_ps(f_z, f_z)), eps));
+    f_x = _mm_mul_ps(f_x, inv); f_y = _mm_mul_ps(f_y, inv); f_z = _mm_mul_ps(f_z, inv);
+
+    // Direção desejada: corpo -> alvo, projetada no plano tangente. Se a
+    // projeção é nula, o corpo mantém a direção atual.
+    __m128 d_x = _mm_sub_ps(_mm_set1_ps(target.x), x4);
+    __m128 d_y = _mm_sub_ps(_mm_set1_ps(target.y), y4);
+    __m128 d_z = _mm_sub_ps(_mm_set1_ps(target.z), z4);
+    dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(d_x, px), _mm_mul_ps(d_y, py)), _mm_mul_ps(d_z, pz));
+    d_x = _mm_sub_ps(d_x, _mm_mul_ps(dot, px));
+    d_y = _mm_sub_ps(d_y, _mm_mul_ps(dot, py));
+    d_z = _mm_sub_ps(d_z, _mm_mul_ps(dot, pz));
+    __m128 d2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(d_x, d_x), _mm_mul_ps(d_y, d_y)), _mm_mul_ps(d_z, d_z));
+    __m128 has_target = _mm_cmpgt_ps(d2, eps);
+    inv = Orbit_InvSqrt(_mm_max_ps(d2, eps));
+    d_x = Orbit_Select(has_target, _mm_mul_ps(d_x, inv), f_x);
+    d_y = Orbit_Select(has_target, _mm_mul_ps(d_y, inv), f_y);
+    d_z = Orbit_Select(has_target, _mm_mul_ps(d_z, inv), f_z);
+
+    // Cosseno do ângulo até o alvo
+    __m128 cos_a = _mm_add_ps(_mm_add_ps(_mm_mul_ps(f_x, d_x), _mm_mul_ps(f_y, d_y)), _mm_mul_ps(f_z, d_z));
+
+    // g: direção no plano tangente, perpendicular a f, do lado do alvo. Com o
+    // alvo exatamente atrás, gira para a direita (p x f).
+    __m128 g_x = _mm_sub_ps(d_x, _mm_mul_ps(cos_a, f_x));
+    __m128 g_y = _mm_sub_ps(d_y, _mm_mul_ps(cos_a, f_y));
+    __m128 g_z = _mm_sub_ps(d_z, _mm_mul_ps(cos_a, f_z));
+    __m128 g2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(g_x, g_x), _mm_mul_ps(g_y, g_y)), _mm_mul_ps(g_z, g_z));
+    __m128 has_side = _mm_cmpgt_ps(g2, eps);
+    inv = Orbit_InvSqrt(_mm_max_ps(g2, eps));
+    g_x = Orbit_Select(has_side, _mm_mul_ps(g_x, inv), _mm_sub_ps(_mm_mul_ps(py, f_z), _mm_mul_ps(pz, f_y)));
+    g_y = Orbit_Select(has_side, _mm_mul_ps(g_y, inv), _mm_sub_ps(_mm_mul_ps(pz, f_x), _mm_mul_ps(px, f_z)));
+    g_z = Orbit_Select(has_side, _mm_mul_ps(g_z, inv), _mm_sub_ps(_mm_mul_ps(px, f_y), _mm_mul_ps(py, f_x)));
+
+    // Alvo dentro do giro máximo: aponta para ele; senão gira max_turn
+    __m128 reach = _mm_cmpge_ps(cos_a, _mm_set1_ps(cos_max));
+    __m128 vc = _mm_set1_ps(cos_max), vs = _mm_set1_ps(sin_max);
+    _mm_storeu_ps(fx, Orbit_Select(reach, d_x, _mm_add_ps(_mm_mul_ps(f_x, vc), _mm_mul_ps(g_x, vs))));
+    _mm_storeu_ps(fy, Orbit_Select(reach, d_y, _mm_add_ps(_mm_mul_ps(f_y, vc), _mm_mul_ps(g_y, vs))));
+    _mm_storeu_ps(fz, Orbit_Select(reach, d_z, _mm_add_ps(_mm_mul_ps(f_z, vc), _mm_mul_ps(g_z, vs))));
+}
+
+#else
+
+// Mesmo que Orbit_SteerBlock(), para um corpo
+static void Orbit_SteerScalar(float x, float y, float z, float& fx, float& fy, float& fz,
+                              const glm::vec4& target, const glm::vec4& center, float cos_max, float sin_max)
+{
+    float px = x - center.x, py = y - center.y, pz = z - center.z;
+    float inv = 1.0f / std::sqrt(px*px + py*py + pz*pz);
+    px *= inv; py *= inv; pz *= inv;
+
+    float dot = fx*px + fy*py + fz*pz;
+    float f_x = fx - dot*px, f_y = fy - dot*py, f_z = fz - dot*pz;
+    inv = 1.0f / std::sqrt(f_x*f_x + f_y*f_y + f_z*f_z + steerEpsilon);
+    f_x *= inv; f_y *= inv; f_z *= inv;
+
+    float d_x = target.x - x, d_y = target.y - y, d_z = target.z - z;
+    dot = d_x*px + d_y*py + d_z*pz;
+    d_x -= dot*px; d_y -= dot*py; d_z -= dot*pz;
+    float d2 = d_x*d_x + d_y*d_y + d_z*d_z;
+    if (d2 > steerEpsilon) {
+        inv = 1.0f / std::sqrt(d2);
+        d_x *= inv; d_y *= inv; d_z *= inv;
+    } else {
+        d_x = f_x; d_y = f_y; d_z = f_z;
+    }
+
+    float cos_a = f_x*d_x + f_y*d_y + f_z*d_z;
+    if (cos_a >= cos_max) {
+        fx = d_x; fy = d_y; fz = d_z;
+        return;
+    }
+
+    float g_x = d_x - cos_a*f_x, g_y = d_y - cos_a*f_y, g_z = d_z - cos_a*f_z;
+    float g2 = g_x*g_x + g_y*g_y + g_z*g_z;
+    if (g2 > steerEpsilon) {
+        inv = 1.0f / std::sqrt(g2);
+        g_x *= inv; g_y *= inv; g_z *= inv;
+    } else {
+        g_x = py*f_z - pz*f_y; g_y = pz*f_x - px*f_z; g_z = px*f_y - py*f_x;
+    }
+
+    fx = f_x*cos_max + g_x*sin_max;
+    fy = f_y*cos_max + g_y*sin_max;
+    fz = f_z*cos_max + g_z*sin_max;
+}
+
+#endif
+
+void Orbit_Steer(const float* x, const float* y, const float* z, float* fx, float* fy, float* fz, size_t n,
+                 const glm::vec4& target, const glm::vec4& center, float max_turn)
+{
+    float cos_max = std::cos(max_turn);
+    float sin_max = std::sin(max_turn);
+
+#ifdef ORBIT_USE_SSE
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+        Orbit_SteerBlock(x + i, y + i, z + i, fx + i, fy + i, fz + i, target, center, cos_max, sin_max);
+
+    // Resto: copiado para um bloco de 4, completado com o primeiro corpo do
+    // resto, para que cada corpo tenha o mesmo resultado em qualquer posição
+    if (i < n)
+    {
+        float bx[4], by[4], bz[4], bfx[4], bfy[4], bfz[4];
+        for (size_t k = 0; k < 4; ++k)
+        {
+            size_t j = (i + k < n) ? i + k : i;
+            bx[k] = x[j]; by[k] = y[j]; bz[k] = z[j];
+            bfx[k] = fx[j]; bfy[k] = fy[j]; bfz[k] = fz[j];
+        }
+
+        Orbit_SteerBlock(bx, by, bz, bfx, bfy, bfz, target, center, cos_max, sin_max);
+
+        for (size_t k = 0; i + k < n; ++k)
+        {
+            fx[i + k] = bfx[k]; fy[i + k] = bfy[k]; fz[i + k] = bfz[k];
+        }
+    }
+#else
+    for (size_t i = 0; i < n; ++i)
+        Orbit_SteerScalar(x[i], y[i], z[i], fx[i], fy[i], fz[i], target, center, cos_max, sin_max);
+#endif
+}
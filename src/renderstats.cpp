@@ -0,0 +1,139 @@
+// Camada de contagem em torno das chamadas OpenGL usadas na renderização.
+// Veja "renderstats.h".
+#include <cstdio>
+#include <cstring>
+
+#include "renderstats.h"
+
+RenderStats renderstats_current;
+RenderStats renderstats_last;
+
+FILE* renderstats_log = NULL;
+long  renderstats_log_frame = 0;
+
+// Número de triângulos gerados por "count" vértices no modo "mode"
+static unsigned int RenderStats_Triangles(GLenum mode, GLsizei count)
+{
+    switch (mode)
+    {
+        case GL_TRIANGLES:      return count / 3;
+        case GL_TRIANGLE_STRIP:
+        case GL_TRIANGLE_FAN:   return count > 2 ? count - 2 : 0;
+        default:                return 0;
+    }
+}
+
+void RenderStats_DrawElements(GLenum mode, GLsizei count, GLenum type, const void* indices)
+{
+    renderstats_current.draw_calls += 1;
+    renderstats_current.triangles += RenderStats_Triangles(mode, count);
+    glDrawElements(mode, count, type, indices);
+}
+
+void RenderStats_DrawArrays(GLenum mode, GLint first, GLsizei count)
+{
+    renderstats_current.draw_calls += 1;
+    renderstats_current.triangles += RenderStats_Triangles(mode, count);
+    glDrawArrays(mode, first, count);
+}
+
+void RenderStats_Uniform1i(GLint location, GLint v0)
+{
+    renderstats_current.uniform_uploads += 1;
+    glUniform1i(location, v0);
+}
+
+void RenderStats_Uniform4f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3)
+{
+    renderstats_current.uniform_uploads += 1;
+    glUniform4f(location, v0, v1, v2, v3);
+}
+
+void RenderStats_UniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
+{
+    renderstats_current.uniform_uploads += 1;
+    glUniformMatrix4fv(location, count, transpose, value);
+}
+
+void RenderStats_UseProgram(GLuint program)
+{
+    renderstats_current.program_binds += 1;
+    glUseProgram(program);
+}
+
+void RenderStats_BindVertexArray(GLuint array)
+{
+    renderstats_current.vao_binds += 1;
+    glBindVertexArray(array);
+}
+
+void RenderStats_BufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage)
+{
+    renderstats_current.buffer_uploads += 1;
+    if (data)
+        renderstats_current.buffer_bytes += size;
+    glBufferData(target, size, data, usage);
+}
+
+void RenderStats_BufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data)
+{
+    renderstats_current.buffer_uploads += 1;
+    renderstats_current.buffer_bytes += size;
+    glBufferSubData(target, offset, size, data);
+}
+
+void RenderStats_CountCulled()
+{
+    renderstats_current.culled_objects += 1;
+}
+
+void RenderStats_EndFrame()
+{
+    renderstats_last = renderstats_current;
+
+    if (renderstats_log)
+    {
+        const RenderStats& s = renderstats_last;
+        fprintf(renderstats_log, "%ld,%u,%u,%u,%u,%u,%u,%lu,%u\n", renderstats_log_frame++,
+                s.draw_calls, s.triangles, s.uniform_uploads, s.program_binds, s.vao_binds,
+                s.buffer_uploads, (unsigned long)s.buffer_bytes, s.culled_objects);
+    }
+
+    memset(&renderstats_current, 0, sizeof(RenderStats));
+}
+
+const RenderStats& RenderStats_LastFrame()
+{
+    return renderstats_last;
+}
+
+bool RenderStats_StartLog(const char* filename)
+{
+    if (renderstats_log)
+        fclose(renderstats_log);
+
+    renderstats_log = fopen(filename, "w");
+    if (!renderstats_log)
+    {
+        fprintf(stderr, "ERROR: Cannot open file \"%s\".\n", filename);
+        return false;
+    }
+
+    fprintf(renderstats_log, "frame,draw_calls,triangles,uniform_uploads,program_binds,vao_binds,buffer_uploads,buffer_bytes,culled_objects\n");
+    renderstats_log_frame = 0;
+    return true;
+}
+
+void RenderStats_StopLog()
+{
+    if (renderstats_log)
+    {
+        fclose(renderstats_log);
+        renderstats_log = NULL;
+    }
+}
+
+bool RenderStats_IsLogging()
+{
+    return renderstats_log != NULL;
+}
@@ -0,0 +1,408 @@
+// Consultas de raio e de esfera sobre as entidades. Veja "scenequery.h".
+#include <cmath>
+#include <algorithm>
+
+#include "scenequery.h"
+#include "jobsystem.h"
+#include "bvh.h"
+#include "meshcollider.h"
+
+// Mesma resolução da grade de colisões da simulação (células de cerca de 1.6
+// unidades na órbita). Com poucos inimigos, testar todos custa menos.
+static const int sceneQueryGridResolution = 16;
+static const size_t sceneQueryGridMinEnemies = 64;
+
+// Os raios são divididos em trechos deste comprimento, e cada trecho consulta
+// na grade somente as células em volta dele. Raios que dariam mais trechos
+// que sceneQueryMaxRayPieces testam todos os inimigos.
+static const float sceneQueryRayPiece = 2.0f;
+static const int sceneQueryMaxRayPieces = 32;
+
+// Candidatas testadas por vez nos testes em lote (máscara na pilha)
+static const size_t sceneQueryBatchBlock = 256;
+
+// Raios por tarefa em SceneQuery_RaycastBatch()
+static const size_t sceneQueryRayGrain = 64;
+
+// Esfera envolvente de uma nave (a do jogador ou um inimigo)
+static BoundingSphere SceneQuery_ShipSphere(const GameState& state, const glm::vec4& position, const glm::vec4& forward)
+{
+    const EntityBounds& bounds = state.aircraftBounds;
+    if (!bounds.fitted) {
+        BoundingSphere sphere = { position, AIRCRAFT_SPHERE_RADIUS };
+        return sphere;
+    }
+
+    BoundingSphere sphere = { Sim_OrbitFrame(position, forward) * bounds.local.sphere.center, bounds.local.sphere.radius };
+    return sphere;
+}
+
+// Com os triângulos da malha da nave (Sim_SetAircraftMesh()), confirma neles
+// um contato do raio com a esfera envolvente "sphere", que começa na distância
+// t, e devolve em t a distância até o primeiro triângulo. O trecho testado
+// atravessa somente a esfera.
+static bool SceneQuery_RayShipMesh(const GameState& state, const Ray& ray, float max_distance,
+                                   const glm::vec4& position, const glm::vec4& forward,
+                                   const BoundingSphere& sphere, float& t)
+{
+    const EntityBounds& bounds = state.aircraftBounds;
+    if (!bounds.fitted || !bounds.mesh)
+        return true;
+
+    float end = std::min(t + 2.0f * sphere.radius, max_distance);
+    float s;
+    if (!MeshCollider_Segment(*bounds.mesh, Sim_OrbitFrame(position, forward),
+                              ray.origin + t * ray.direction, ray.origin + end * ray.direction, s))
+        return false;
+
+    t += s * (end - t);
+    return true;
+}
+
+// Distância máxima da posição de uma nave até o volume dela
+static float SceneQuery_ShipReach(const GameState& state)
+{
+    return state.aircraftBounds.fitted ? state.aircraftBounds.reach : AIRCRAFT_SPHERE_RADIUS;
+}
+
+// Caixa do asteroide i: a caixa orientada ajustada à malha, ou a do cilindro
+static BoundingOBB SceneQuery_AsteroidBox(const GameState& state, size_t i)
+{
+    glm::vec4 position = state.randomAsteroids.position(i);
+
+    if (state.asteroidBounds.fitted) {
+        BoundingOBB box = state.asteroidBounds.local.box;
+        box.center += position - glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+        return box;
+    }
+
+    BoundingOBB box;
+    box.center = position;
+    box.axis[0] = glm::vec4(1.0f, 0.0f, 0.0f, 0.0f);
+    box.axis[1] = glm::vec4(0.0f, 1.0f, 0.0f, 0.0f);
+    box.axis[2] = glm::vec4(0.0f, 0.0f, 1.0f, 0.0f);
+    box.halfSize[0] = ASTEROID_CYLINDER_RADIUS;
+    box.halfSize[1] = ASTEROID_CYLINDER_HEIGHT / 2.0f;
+    box.halfSize[2] = ASTEROID_CYLINDER_RADIUS;
+    return box;
+}
+
+// A BVH do estado só vale se foi montada com todos os asteroides atuais
+static bool SceneQuery_HasAsteroidBvh(const GameState& state)
+{
+    return Bvh_ItemCount(state.asteroidBvh) == state.randomAsteroids.indexOf.size()
+        && Bvh_AliveCount(state.asteroidBvh) == state.randomAsteroids.size();
+}
+
+// Raio-esfera com distância 0 quando a origem do raio está dentro da esfera
+static bool SceneQuery_RaySphere(const Ray& ray, const BoundingSphere& sphere, float max_distance, float& t)
+{
+    if (distanceSq(ray.origin, sphere.center) <= sphere.radius * sphere.radius) {
+        t = 0.0f;
+        return true;
+    }
+    return checkRaySphereCollision(ray, sphere, t) && t <= max_distance;
+}
+
+// Chama candidate(i) para cada uma das n esferas (centros x, y, z, raio
+// "radius") que o raio toca até "max_distance", usando os testes em lote
+template <typename Candidate>
+static void SceneQuery_RayBatch(const Ray& ray, float max_distance, const float* x, const float* y, const float* z,
+                                float radius, size_t n, const Candidate& candidate)
+{
+    unsigned int mask[COLLISION_MASK_WORDS(sceneQueryBatchBlock)];
+    unsigned int list[sceneQueryBatchBlock];
+    float t[sceneQueryBatchBlock];
+
+    for (size_t begin = 0; begin < n; begin += sceneQueryBatchBlock) {
+        size_t count = std::min(sceneQueryBatchBlock, n - begin);
+        if (checkRaySphereBatch(ray, x + begin, y + begin, z + begin, radius, count, mask, t) == 0)
+            continue;
+
+        // Com a origem dentro da esfera, t é a distância até a saída, no
+        // máximo o diâmetro; nos outros casos, até a entrada
+        size_t hits = collisionHitList(mask, count, list);
+        for (size_t k = 0; k < hits; ++k)
+            if (t[list[k]] <= max_distance + 2.0f * radius)
+                candidate(begin + list[k]);
+    }
+}
+
+// Chama candidate(i) para cada uma das n esferas que tocam "sphere"
+template <typename Candidate>
+static void SceneQuery_SphereBatch(const BoundingSphere& sphere, const float* x, const float* y, const float* z,
+                                   float radius, size_t n, const Candidate& candidate)
+{
+    unsigned int mask[COLLISION_MASK_WORDS(sceneQueryBatchBlock)];
+    unsigned int list[sceneQueryBatchBlock];
+
+    for (size_t begin = 0; begin < n; begin += sceneQueryBatchBlock) {
+        size_t count = std::min(sceneQueryBatchBlock, n - begin);
+        if (checkSphereSphereBatch(sphere, x + begin, y + begin, z + begin, radius, count, mask) == 0)
+            continue;
+
+        size_t hits = collisionHitList(mask, count, list);
+        for (size_t k = 0; k < hits; ++k)
+            candidate(begin + list[k]);
+    }
+}
+
+// Chama visit(category, index, distance) para cada alvo atingido pelo raio.
+// Um inimigo pode ser visitado mais de uma vez (por trechos vizinhos do raio).
+template <typename Visit>
+static void SceneQuery_ForEachRayHit(const SceneQuery& query, const Ray& ray, float max_distance,
+                                     unsigned int categories, const Visit& visit)
+{
+    const GameState& state = *query.state;
+    float t;
+
+    if (categories & QUERY_AIRCRAFT) {
+        BoundingSphere sphere = SceneQuery_ShipSphere(state, state.aircraftPosition, state.aircraftForward);
+        if (SceneQuery_RaySphere(ray, sphere, max_distance, t)
+            && SceneQuery_RayShipMesh(state, ray, max_distance, state.aircraftPosition, state.aircraftForward, sphere, t))
+            visit(QUERY_AIRCRAFT, 0, t);
+    }
+
+    if (categories & QUERY_ENEMY) {
+        const EnemyArray& enemies = state.enemies;
+        float reach = SceneQuery_ShipReach(state);
+
+        auto test = [&](size_t i) {
+            BoundingSphere sphere = SceneQuery_ShipSphere(state, enemies.position(i), enemies.forward(i));
+            float t_enemy;
+            if (SceneQuery_RaySphere(ray, sphere, max_distance, t_enemy)
+                && SceneQuery_RayShipMesh(state, ray, max_distance, enemies.position(i), enemies.forward(i), sphere, t_enemy))
+                visit(QUERY_ENEMY, (int)i, t_enemy);
+        };
+
+        float pieces_f = std::ceil(max_distance / sceneQueryRayPiece);
+        if (query.useEnemyGrid && pieces_f <= sceneQueryMaxRayPieces) {
+            int pieces = std::max((int)pieces_f, 1);
+            float length = max_distance / pieces;
+            for (int p = 0; p < pieces; ++p) {
+                glm::vec4 center = ray.origin + ((p + 0.5f) * length) * ray.direction;
+                SphereGrid_Query(query.enemyGrid, center, 0.5f * length + reach, [&](unsigned int k) {
+                    test(query.enemyGrid.items[k]);
+                });
+            }
+        } else {
+            SceneQuery_RayBatch(ray, max_distance, enemies.x.data(), enemies.y.data(), enemies.z.data(),
+                                reach, enemies.size(), test);
+        }
+    }
+
+    if (categories & QUERY_ASTEROID) {
+        const AsteroidArray& asteroids = state.randomAsteroids;
+        auto test = [&](size_t i) {
+            float t_asteroid;
+            if (checkRayOBBCollision(ray, SceneQuery_AsteroidBox(state, i), t_asteroid) && t_asteroid <= max_distance)
+                visit(QUERY_ASTEROID, (int)i, t_asteroid);
+        };
+
+        if (SceneQuery_HasAsteroidBvh(state)) {
+            glm::vec4 end = ray.origin + max_distance * ray.direction;
+            Bvh_QuerySegment(state.asteroidBvh, ray.origin, end, 0.0f, [&](unsigned int id) {
+                test(asteroids.indexOf[id]);
+            });
+        } else {
+            for (size_t i = 0; i < asteroids.size(); ++i)
+                test(i);
+        }
+    }
+
+    if (categories & QUERY_CHECKPOINT) {
+        for (size_t i = 0; i < state.checkpoints.size(); ++i)
+            if (SceneQuery_RaySphere(ray, getCheckpointBoundingSphere(state.checkpoints[i]), max_distance, t))
+                visit(QUERY_CHECKPOINT, (int)i, t);
+    }
+
+    if (categories & QUERY_MISSILE) {
+        const MissilePool& missiles = state.missiles;
+        SceneQuery_RayBatch(ray, max_distance, missiles.x.data(), missiles.y.data(), missiles.z.data(),
+                            missileRadius, missiles.size(), [&](size_t i) {
+            BoundingSphere sphere = { missiles.position(i), missileRadius };
+            float t_missile;
+            if (SceneQuery_RaySphere(ray, sphere, max_distance, t_missile))
+                visit(QUERY_MISSILE, (int)i, t_missile);
+        });
+    }
+}
+
+// Ordem dos alvos no mesmo ponto do raio (e das listas das esferas)
+static bool SceneQuery_HitBefore(const SceneQueryHit& a, const SceneQueryHit& b)
+{
+    if (a.distance != b.distance)
+        return a.distance < b.distance;
+    if (a.category != b.category)
+        return a.category < b.category;
+    return a.index < b.index;
+}
+
+static bool SceneQuery_SameTarget(const SceneQueryHit& a, const SceneQueryHit& b)
+{
+    return a.category == b.category && a.index == b.index;
+}
+
+static bool SceneQuery_TargetLess(const SceneQueryHit& a, const SceneQueryHit& b)
+{
+    if (a.category != b.category)
+        return a.category < b.category;
+    return a.index < b.index;
+}
+
+void SceneQuery_Update(SceneQuery& query, const GameState& state)
+{
+    query.state = &state;
+
+    const EnemyArray& enemies = state.enemies;
+    query.useEnemyGrid = enemies.size() >= sceneQueryGridMinEnemies;
+    if (!query.useEnemyGrid)
+        return;
+
+    if (query.enemyGrid.cellStart.empty())
+        SphereGrid_Init(query.enemyGrid, moon_position, sceneQueryGridResolution);
+    SphereGrid_Build(query.enemyGrid, enemies.x.data(), enemies.y.data(), enemies.z.data(), enemies.size());
+}
+
+bool SceneQuery_RaycastClosest(const SceneQuery& query, const Ray& ray, float max_distance,
+                               unsigned int categories, SceneQueryHit& hit)
+{
+    hit.category = 0;
+    hit.index = -1;
+    hit.distance = max_distance;
+
+    SceneQuery_ForEachRayHit(query, ray, max_distance, categories, [&](unsigned int category, int index, float t) {
+        SceneQueryHit candidate = { category, index, t };
+        if (hit.index < 0 || SceneQuery_HitBefore(candidate, hit))
+            hit = candidate;
+    });
+
+    return hit.index >= 0;
+}
+
+size_t SceneQuery_RaycastAll(const SceneQuery& query, const Ray& ray, float max_distance,
+                             unsigned int categories, std::vector<SceneQueryHit>& hits)
+{
+    hits.clear();
+    SceneQuery_ForEachRayHit(query, ray, max_distance, categories, [&](unsigned int category, int index, float t) {
+        SceneQueryHit hit = { category, index, t };
+        hits.push_back(hit);
+    });
+
+    // Um inimigo visitado por dois trechos do raio aparece uma vez
+    std::sort(hits.begin(), hits.end(), SceneQuery_TargetLess);
+    hits.erase(std::unique(hits.begin(), hits.end(), SceneQuery_SameTarget), hits.end());
+    std::sort(hits.begin(), hits.end(), SceneQuery_HitBefore);
+    return hits.size();
+}
+
+size_t SceneQuery_OverlapSphere(const SceneQuery& query, const BoundingSphere& sphere,
+                                unsigned int categories, std::vector<SceneQueryHit>& hits)
+{
+    const GameState& state = *query.state;
+    hits.clear();
+
+    auto add = [&](unsigned int category, size_t index) {
+        SceneQueryHit hit = { category, (int)index, 0.0f };
+        hits.push_back(hit);
+    };
+
+    // Naves: a esfera envolvente e, com volumes ajustados, também a cápsula
+    // e os triângulos da malha (se houver), como nas colisões
+    auto touchesShip = [&](const glm::vec4& position, const glm::vec4& forward) {
+        if (!checkSphereSphereCollision(SceneQuery_ShipSphere(state, position, forward), sphere))
+            return false;
+        const EntityBounds& bounds = state.aircraftBounds;
+        if (!bounds.fitted)
+            return true;
+
+        const BoundingCapsule& local = bounds.local.capsule;
+        glm::mat4 frame = Sim_OrbitFrame(position, forward);
+        BoundingCapsule capsule = { frame * local.a, frame * local.b, local.radius };
+        if (!checkCapsuleSphereCollision(capsule, sphere))
+            return false;
+        return !bounds.mesh || MeshCollider_OverlapSphere(*bounds.mesh, frame, sphere.center, sphere.radius);
+    };
+
+    if ((categories & QUERY_AIRCRAFT) && touchesShip(state.aircraftPosition, state.aircraftForward))
+        add(QUERY_AIRCRAFT, 0);
+
+    if (categories & QUERY_ENEMY) {
+        const EnemyArray& enemies = state.enemies;
+        size_t first = hits.size();
+        auto test = [&](size_t i) {
+            if (touchesShip(enemies.position(i), enemies.forward(i)))
+                add(QUERY_ENEMY, i);
+        };
+
+        float reach = SceneQuery_ShipReach(state);
+        if (query.useEnemyGrid) {
+            SphereGrid_Query(query.enemyGrid, sphere.center, sphere.radius + reach, [&](unsigned int k) {
+                test(query.enemyGrid.items[k]);
+            });
+            std::sort(hits.begin() + first, hits.end(), SceneQuery_TargetLess);
+        } else {
+            SceneQuery_SphereBatch(sphere, enemies.x.data(), enemies.y.data(), enemies.z.data(),
+                                   reach, enemies.size(), test);
+        }
+    }
+
+    if (categories & QUERY_ASTEROID) {
+        const AsteroidArray& asteroids = state.randomAsteroids;
+        size_t first = hits.size();
+        auto test = [&](size_t i) {
+            bool touches = state.asteroidBounds.fitted
+                ? checkOBBSphereCollision(SceneQuery_AsteroidBox(state, i), sphere)
+                : checkCylinderSphereCollision(getAsteroidBoundingCylinder(asteroids.position(i)), sphere);
+            if (touches)
+                add(QUERY_ASTEROID, i);
+        };
+
+        if (SceneQuery_HasAsteroidBvh(state)) {
+            // O teste do cilindro soma os raios e as alturas separadamente: a
+            // região aceita cabe na caixa do cilindro aumentada do raio da
+            // esfera em cada eixo, mas não na esfera em volta da caixa
+            BvhBox box;
+            float c[3] = { sphere.center.x, sphere.center.y, sphere.center.z };
+            for (int a = 0; a < 3; ++a) {
+                box.min[a] = c[a] - sphere.radius;
+                box.max[a] = c[a] + sphere.radius;
+            }
+            Bvh_QueryBox(state.asteroidBvh, box, [&](unsigned int id) {
+                test(asteroids.indexOf[id]);
+            });
+            std::sort(hits.begin() + first, hits.end(), SceneQuery_TargetLess);
+        } else {
+            for (size_t i = 0; i < asteroids.size(); ++i)
+                test(i);
+        }
+    }
+
+    if (categories & QUERY_CHECKPOINT) {
+        for (size_t i = 0; i < state.checkpoints.size(); ++i)
+            if (checkSphereSphereCollision(getCheckpointBoundingSphere(state.checkpoints[i]), sphere))
+                add(QUERY_CHECKPOINT, i);
+    }
+
+    if (categories & QUERY_MISSILE) {
+        const MissilePool& missiles = state.missiles;
+        SceneQuery_SphereBatch(sphere, missiles.x.data(), missiles.y.data(), missiles.z.data(),
+                               missileRadius, missiles.size(), [&](size_t i) { add(QUERY_MISSILE, i); });
+    }
+
+    return hits.size();
+}
+
+void SceneQuery_RaycastBatch(const SceneQuery& query, const Ray* rays, size_t n, float max_distance,
+                             unsigned int categories, SceneQueryHit* hits, JobSystem* jobs)
+{
+    auto body = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+            SceneQuery_RaycastClosest(query, rays[i], max_distance, categories, hits[i]);
+    };
+
+    if (jobs && n >= 2 * sceneQueryRayGrain)
+        JobSystem_ParallelFor(*jobs, n, sceneQueryRayGrain, body);
+    else if (n > 0)
+        body(0, n);
+}
@@ -24,8 +24,6 @@ uniform mat4 projection;
 #define PLANE 2
 #define ENEMY 3
 #define CHECKPOINT_SPHERE 4
-#define HEALTH_BAR_BACKGROUND 5
-#define HEALTH_BAR_FOREGROUND 6
 #define ASTEROID 7
 
 uniform int object_id;
@@ -106,13 +104,6 @@ void main()
         }
 
     }  
-    else if ( object_id == SKYBOX )
-    {
-        U = texcoords.x;
-        V = texcoords.y; 
-        Kd0 = texture(TextureImage0, vec2(U,V)).rgb;
-
-    }
     else if ( object_id == PLANE )
     {
         Ks = vec3(0.3,0.3,0.3);
@@ -143,14 +134,6 @@ void main()
         Kd0 = texture(TextureImage0, vec2(U,V)).rgb;
 
         color.rgb = Kd0;
-    } else if (object_id == HEALTH_BAR_BACKGROUND)
-    {
-        color = vec4(0.3, 0.3, 0.3, 1.0);
-        return;
-    } else if (object_id == HEALTH_BAR_FOREGROUND)
-    {
-        color = vec4(0.1, 0.8, 0.1, 1.0);
-        return;
     } else if ( object_id == ASTEROID )
     {
         Ks = vec3(0.3,0.3,0.3);
@@ -185,7 +168,7 @@ void main()
     vec4 h = normalize(v + l); 
     vec3 specular_term = Ks * I * pow(max(0, dot(h, n)), q); 
 
-    if(object_id == SKYBOX || object_id == CHECKPOINT_SPHERE){
+    if(object_id == CHECKPOINT_SPHERE){
         color.rgb = Kd0; 
     }  else if(gouraud){
         color.rgb = Kd0 * color_v.rgb;
@@ -0,0 +1,21 @@
+#version 330 core
+
+// Direção de visão no sistema de coordenadas global, interpolada pelo
+// rasterizador a partir do triângulo gerado em "shader_sky_vertex.glsl".
+in vec3 view_direction;
+
+// Cubemap gerado a partir da imagem equiretangular "skybox.jpeg". Veja a
+// função LoadCubemapFromEquirectangular() em "main.cpp".
+uniform samplerCube SkyboxCubemap;
+
+out vec4 color;
+
+void main()
+{
+    color.rgb = texture(SkyboxCubemap, normalize(view_direction)).rgb;
+    color.a = 1.0;
+
+    // Cor final com correção gamma, considerando monitor sRGB (mesma
+    // correção de "shader_fragment.glsl").
+    color.rgb = pow(color.rgb, vec3(1.0,1.0,1.0)/2.2);
+}
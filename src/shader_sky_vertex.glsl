@@ -0,0 +1,25 @@
+#version 330 core
+
+// Vertex shader do céu (skybox). Não recebe atributos de vértice: um único
+// triângulo que cobre toda a tela é gerado a partir de gl_VertexID. Veja a
+// chamada glDrawArrays(GL_TRIANGLES, 0, 3) em "main.cpp".
+
+// Inversa de (projection * view), onde "view" não possui translação. Leva um
+// ponto em NDC de volta para uma direção no sistema de coordenadas global.
+uniform mat4 inverse_view_projection;
+
+out vec3 view_direction;
+
+void main()
+{
+    // Vértices (-1,-1), (3,-1) e (-1,3): o triângulo cobre todo o quadrado NDC.
+    vec2 p = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2) * 2.0 - 1.0;
+
+    // z = w faz com que a profundidade final seja 1.0 (o "far plane"), de
+    // forma que o teste GL_LEQUAL descarta os fragmentos já cobertos pela
+    // lua, naves, etc.
+    gl_Position = vec4(p, 1.0, 1.0);
+
+    vec4 direction = inverse_view_projection * vec4(p, 1.0, 1.0);
+    view_direction = direction.xyz / direction.w;
+}
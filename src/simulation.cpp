@@ -0,0 +1,1047 @@
+// Lógica do jogo: movimento da nave, dos inimigos e dos mísseis sobre a órbita
+// da lua, colisões e condições de fim de jogo. Veja "simulation.h".
+#include <cmath>
+#include <algorithm>
+
+#include "simulation.h"
+#include "matrices.h"
+#include "collisions.h"
+#include "orbitmotion.h"
+#include "jobsystem.h"
+#include "bvh.h"
+#include "meshcollider.h"
+
+// Variaveis de posição da lua
+const glm::vec4 moon_position = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+const float orbitDistance = 16.0f;
+
+const float turnRate = 2.0f; // Velocidade máxima de giro
+const float enemySpeed = 5.0f; // Velocidade do inimigo
+
+const glm::vec4 g_Asteroid_P0 = glm::vec4(21.0f, 0.0f, 0.0f, 1.0f);
+const glm::vec4 g_Asteroid_P1 = glm::vec4(17.0f, 4.0f, 4.0f, 1.0f);
+const glm::vec4 g_Asteroid_P2 = glm::vec4(25.0f, 4.0f, -4.0f, 1.0f);
+const glm::vec4 g_Asteroid_P3 = glm::vec4(21.0f, 0.0f, 0.0f, 1.0f);
+const float asteroidSpeed = 0.50f;
+const float asteroidScale = 0.0004f;
+
+const int numRandomAsteroids = 8;
+
+const float missileSpeed = 20.0f;
+const float missileLifespan = 2.0f; // 2 segundos de vida
+const float missileRadius = 0.15f;
+
+const float shootColdownTimer = 1.0f; // Intervalo de 1s entre tiros
+
+const float enemyShotSpeed = 7.0f; // Cada inimigo atira a cada 7 segundos
+
+const float damageDuration = 0.2f; // Nave fica vermelha por 0.2 segundos
+
+// Eventos agendados em state.timers
+enum SimTimer {
+    TIMER_ENEMY_SHOT,      // a: id do inimigo
+    TIMER_MISSILE_EXPIRE,  // a, b: handle do míssil
+    TIMER_DAMAGE_END,
+    TIMER_PLAYER_RELOAD
+};
+
+const double timerTicksPerSecond = 60.0;
+
+// Grades de broadphase das colisões (veja "spheregrid.h"), com células de
+// cerca de 1.6 unidades na órbita. Elas só são reconstruídas quando há
+// entidades e mísseis suficientes: com poucos, testar todos os pares custa
+// menos que montar a grade.
+const int sphereGridResolution = 16;
+const size_t sphereGridMinTargets = 64;
+const size_t sphereGridMinMissiles = 8;
+
+// Abaixo deste número de asteroides, testar todos custa menos que descer pela
+// BVH (que continua sendo mantida)
+const size_t asteroidBvhMinAsteroids = 32;
+
+// Maior número de subpassos ao confirmar um contato com os volumes ajustados
+// às malhas (veja refineHit())
+const int maxRefineSteps = 16;
+
+// Contatos reservados para as colisões na primeira partida. O vetor cresce se
+// for preciso, e a memória fica para os passos seguintes.
+const size_t collisionEventsCapacity = 256;
+
+static void moveAircraft(GameState& state, const SimInput& input, float delta_t);
+static void InitEnemies(GameState& state);
+static void moveEnemies(GameState& state, float delta_t, JobSystem* jobs);
+static void processCollisions(GameState& state, JobSystem* jobs);
+static void initCheckpoints(GameState& state);
+static void initRandomAsteroids(GameState& state);
+static void fireMissile(GameState& state, const glm::vec4& startPos, const glm::vec4& direction, int ownerId);
+static void updateMissiles(GameState& state, float delta_t, JobSystem* jobs);
+static void processTimers(GameState& state);
+
+// Tamanho dos blocos de entidades de cada tarefa. Laços com menos de dois
+// blocos (como no jogo normal, com 3 inimigos) são executados direto, já que
+// agendar tarefas custaria mais que o próprio laço.
+const size_t parallelGrain = 512;
+
+// Executa body(begin, end) sobre [0, n), dividido entre as tarefas de "jobs"
+// quando há entidades suficientes. Cada entidade é processada pelo mesmo
+// código qualquer que seja a divisão, então o resultado não muda.
+// O laço direto chama body sem passar por std::function.
+template <typename Body>
+static void parallelRange(JobSystem* jobs, size_t n, const Body& body) {
+    if (jobs && n >= 2 * parallelGrain)
+        JobSystem_ParallelFor(*jobs, n, parallelGrain, body);
+    else if (n > 0)
+        body(0, n);
+}
+
+// Gerador de números aleatórios (xorshift32) de cada partida. Ao contrário de
+// rand(), não tem estado global: partidas diferentes podem ser simuladas ao
+// mesmo tempo e cada uma é reproduzível a partir da sua semente.
+static unsigned int nextRandom(GameState& state) {
+    unsigned int x = state.rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    state.rng = x;
+    return x;
+}
+
+// Função auxiliar para gerar float aleatório entre min e max
+static float randomFloat(GameState& state, float min, float max) {
+    return min + (nextRandom(state) >> 8) * (1.0f / 16777216.0f) * (max - min);
+}
+
+void Sim_Reset(GameState& state, unsigned int seed) {
+    // xorshift não pode partir do estado zero
+    state.rng = seed != 0 ? seed : 0x9E3779B9u;
+
+    state.aircraftLife = MAX_LIFE;
+    state.isGameOver = false;
+    state.aircraftPosition = glm::vec4(0.0f, 0.0f, 16.0f, 1.0f);
+    state.aircraftPositionPrev = state.aircraftPosition;
+    state.aircraftForward = glm::vec4(1.0f, 0.0f, 0.0f, 0.0f);
+    state.aircraftForwardPrev = state.aircraftForward;
+
+    TimerWheel_Reset(state.timers);
+
+    state.enemies.clear();
+    InitEnemies(state);
+    initCheckpoints(state);
+    initRandomAsteroids(state);
+    // A memória dos mísseis é alocada somente na primeira partida
+    if (state.missiles.capacity() == 0)
+        state.missiles.reserve(MISSILE_POOL_CAPACITY);
+    state.missiles.clear();
+    if (state.collisionEvents.capacity() == 0)
+        state.collisionEvents.reserve(collisionEventsCapacity);
+
+    SphereGrid_Init(state.enemyGrid, moon_position, sphereGridResolution);
+
+    state.isDamaged = false;
+    state.playerReloading = false;
+    state.damageTimer.generation = 0;
+    state.asteroidT = 0.0f;
+    state.asteroidTPrev = 0.0f;
+    state.time = 0.0;
+}
+
+// Número de ticks de timer em "seconds" segundos
+static unsigned int timerTicks(double seconds) {
+    return (unsigned int)(seconds * timerTicksPerSecond + 0.5);
+}
+
+static void scheduleTimer(GameState& state, float delay, unsigned int type, unsigned int a = 0, unsigned int b = 0) {
+    TimerEvent event = { type, a, b };
+    TimerWheel_Schedule(state.timers, timerTicks(delay), event);
+}
+
+// Executa um passo de simulação de duração delta_t. Antes de avançar, guarda
+// o estado atual de cada entidade como estado anterior, para a interpolação da
+// renderização e para o teste de colisão da trajetória da nave com os
+// checkpoints.
+void Sim_Step(GameState& state, const SimInput& input, float delta_t, JobSystem* jobs) {
+    state.aircraftPositionPrev = state.aircraftPosition;
+    state.aircraftForwardPrev = state.aircraftForward;
+    state.asteroidTPrev = state.asteroidT;
+
+    EnemyArray& enemies = state.enemies;
+    enemies.prev_x = enemies.x; enemies.prev_y = enemies.y; enemies.prev_z = enemies.z;
+    enemies.prev_fx = enemies.fx; enemies.prev_fy = enemies.fy; enemies.prev_fz = enemies.fz;
+
+    state.missiles.savePrevious();
+
+    // O tempo de jogo, e com ele os eventos agendados, para com o jogo
+    // pausado
+    if (input.running) {
+        state.time += delta_t;
+        processTimers(state);
+    }
+
+    // logica de tiro da nave
+    if (input.fire && input.running && !state.isGameOver && !state.playerReloading) {
+
+        state.playerReloading = true;
+        scheduleTimer(state, shootColdownTimer, TIMER_PLAYER_RELOAD);
+
+        glm::vec4 up_vec = normalizedVec(state.aircraftPosition - moon_position);
+        glm::vec4 front_vec = state.aircraftForward;
+        glm::vec4 right_vec = normalizedVec(crossproduct(up_vec, front_vec));
+
+        glm::vec4 missile_start_pos = state.aircraftPosition + front_vec * 0.5f + right_vec * -0.45f;
+
+        fireMissile(state, missile_start_pos, front_vec, 0); // ownerId 0 = Nave
+    }
+
+    // se o jogo nao acabou, está inicializado e nao esta em free flight
+    if (!Sim_IsGameOver(state) && input.running && !input.freeFlight)
+    {
+        if (jobs && state.enemies.size() + state.missiles.size() >= 2 * parallelGrain) {
+            // Os inimigos perseguem a nave já movida; os mísseis não dependem
+            // de nenhum dos dois. As colisões esperam todo o movimento.
+            JobCounter aircraft_moved, all_moved;
+            JobSystem_Run(*jobs, [&] { moveAircraft(state, input, delta_t); }, &aircraft_moved);
+            JobSystem_RunAfter(*jobs, aircraft_moved, [&] { moveEnemies(state, delta_t, jobs); }, &all_moved);
+            JobSystem_Run(*jobs, [&] { updateMissiles(state, delta_t, jobs); }, &all_moved);
+            JobSystem_Wait(*jobs, all_moved);
+        } else {
+            moveAircraft(state, input, delta_t);
+            moveEnemies(state, delta_t, jobs);
+            updateMissiles(state, delta_t, jobs);
+        }
+        processCollisions(state, jobs);
+    } else if (input.freeFlight && !input.running){ // se o jogo esta em free flight nao pode estar iniciado
+        moveAircraft(state, input, delta_t);
+    }
+
+    state.asteroidT += asteroidSpeed * delta_t;
+
+    // curva de bezier
+    if (state.asteroidT >= 1.0f) {
+        // Reinicia o tempo para loopar a curva local
+        state.asteroidT = 0.0f;
+    }
+}
+
+// Aplica dano à nave (se o jogo ainda não acabou) e liga o feedback de dano,
+// que termina damageDuration segundos depois do último dano
+static void damageAircraft(GameState& state) {
+    if (state.isGameOver)
+        return;
+
+    state.aircraftLife -= 1;
+
+    TimerWheel_Cancel(state.timers, state.damageTimer);
+    TimerEvent event = { TIMER_DAMAGE_END, 0, 0 };
+    state.damageTimer = TimerWheel_Schedule(state.timers, timerTicks(damageDuration), event);
+    state.isDamaged = true;
+}
+
+// Trata os eventos agendados que venceram até o tempo de jogo atual. Somente
+// os eventos vencidos são visitados, e não todas as entidades.
+static void processTimers(GameState& state) {
+    std::vector<TimerEvent>& due = state.dueTimers;
+    due.clear();
+    TimerWheel_Advance(state.timers, timerTicks(state.time), due);
+
+    for (size_t k = 0; k < due.size(); ++k) {
+        const TimerEvent& event = due[k];
+
+        switch (event.type) {
+        case TIMER_ENEMY_SHOT: {
+            // Inimigo já destruído: o evento é descartado
+            int i = event.a < state.enemies.indexOf.size() ? state.enemies.indexOf[event.a] : -1;
+            if (i < 0)
+                break;
+
+            if (!state.isGameOver) {
+                glm::vec4 enemy_forward = state.enemies.forward(i);
+                glm::vec4 missile_start_pos = state.enemies.position(i) + enemy_forward * 0.5f;
+
+                fireMissile(state, missile_start_pos, enemy_forward, 1); // ownerId 1
+            }
+
+            scheduleTimer(state, enemyShotSpeed, TIMER_ENEMY_SHOT, event.a);
+            break;
+        }
+
+        case TIMER_MISSILE_EXPIRE: {
+            // Auto-destruição; não faz nada se o míssil já atingiu algo
+            MissileHandle handle = { event.a, event.b };
+            state.missiles.despawn(handle);
+            break;
+        }
+
+        case TIMER_DAMAGE_END:
+            state.isDamaged = false;
+            break;
+
+        case TIMER_PLAYER_RELOAD:
+            state.playerReloading = false;
+            break;
+        }
+    }
+}
+
+void Sim_ProcessCollisions(GameState& state, JobSystem* jobs) {
+    processCollisions(state, jobs);
+}
+
+// função que testa se o jogo acabou
+bool Sim_IsGameOver(GameState& state) {
+    if (state.aircraftLife <= 0) {
+        state.isGameOver = true;
+        return true;
+    }
+
+    if (state.checkpoints.empty())
+    {
+        state.isGameOver = true;
+        return true;
+    }
+
+    return false;
+}
+
+static void moveAircraft(GameState& state, const SimInput& input, float delta_t) {
+    float speed = 8.0f;
+    float turn_speed = 3.0f;
+
+    // logica de movimentação, baseado na distancia da lua, centro (posição da lua) e alinhando o obj da nave com a tangente da lua para sempre estar alinhado
+    if (input.forward) {
+        float angle = speed * delta_t * 0.05f;
+
+        Orbit_AdvanceOne(state.aircraftPosition, state.aircraftForward, moon_position, orbitDistance, angle);
+
+        // permite direita e esquerda, mas com velocidade reduzida
+        if (input.left || input.right) {
+            float angle = turn_speed * delta_t;
+            if (input.right) angle = -angle; // Inverte para Direita
+
+            // Rotação em torno do eixo UP (Normal da lua): como forward é
+            // tangente, gira no plano de forward e right = up x forward
+            glm::vec4 up_vec = normalizedVec(state.aircraftPosition - moon_position);
+            glm::vec4 right_vec = crossproduct(up_vec, state.aircraftForward);
+
+            state.aircraftForward = normalizedVec(state.aircraftForward * std::cos(angle) + right_vec * std::sin(angle));
+        }
+    } else {
+        // Parada: somente mantém a nave na órbita e a direção tangente
+        Orbit_AdvanceOne(state.aircraftPosition, state.aircraftForward, moon_position, orbitDistance, 0.0f);
+    }
+}
+
+static void InitEnemies(GameState& state) {
+    for(int i = 0; i < 3; i++) {
+        // Posição aleatória na esfera
+        glm::vec4 randomPos = glm::vec4(randomFloat(state, -1.0f, 1.0f), randomFloat(state, -1.0f, 1.0f), randomFloat(state, -1.0f, 1.0f), 0.0f);
+        randomPos = normalizedVec(randomPos) * orbitDistance;
+
+        glm::vec4 position = randomPos + moon_position;
+
+        glm::vec4 up = normalizedVec(position - moon_position);
+        glm::vec4 randomDir = glm::vec4(randomFloat(state, -1.0f, 1.0f), randomFloat(state, -1.0f, 1.0f), randomFloat(state, -1.0f, 1.0f), 0.0f);
+
+        glm::vec4 forward = normalizedVec(randomDir - dotproduct(randomDir, up) * up);
+
+        unsigned int id = state.enemies.push_back(position, forward);
+
+        // Primeiro tiro enemyShotSpeed segundos após o início da partida
+        scheduleTimer(state, enemyShotSpeed, TIMER_ENEMY_SHOT, id);
+    }
+}
+
+static void moveEnemies(GameState& state, float delta_t, JobSystem* jobs) {
+    EnemyArray& enemies = state.enemies;
+
+    // mesma ideia do move aircraft, sempre levando em conta a posição da lua, a distancia do centro e tangente com a lua
+    // o inimigo sempre olha e busca chegar na posição do jogador, como uma caça:
+    // a direção gira para o jogador, no plano tangente, limitada à taxa
+    // máxima de giro (para um movimento suave)
+    // Depois, todos os inimigos avançam o mesmo ângulo na órbita
+    float angle_of_advance = enemySpeed * delta_t * 0.05f;
+    glm::vec4 target = state.aircraftPosition;
+
+    parallelRange(jobs, enemies.size(), [&](size_t begin, size_t end) {
+        Orbit_Steer(&enemies.x[begin], &enemies.y[begin], &enemies.z[begin],
+                    &enemies.fx[begin], &enemies.fy[begin], &enemies.fz[begin], end - begin,
+                    target, moon_position, turnRate * delta_t);
+        Orbit_Advance(&enemies.x[begin], &enemies.y[begin], &enemies.z[begin],
+                      &enemies.fx[begin], &enemies.fy[begin], &enemies.fz[begin], end - begin,
+                      moon_position, orbitDistance, angle_of_advance);
+    });
+}
+
+
+// Fórmula da Curva de Bézier Cúbica
+static glm::vec4 evaluateBezier(glm::vec4 p0, glm::vec4 p1, glm::vec4 p2, glm::vec4 p3, float t) {
+    float u = 1.0f - t;
+    float tt = t * t;
+    float uu = u * u;
+    float uuu = uu * u;
+    float ttt = tt * t;
+
+    return (uuu * p0) + (3 * uu * t * p1) + (3 * u * tt * p2) + (ttt * p3);
+}
+
+glm::vec4 Sim_AsteroidBezierPosition(float t) {
+    return evaluateBezier(g_Asteroid_P0, g_Asteroid_P1, g_Asteroid_P2, g_Asteroid_P3, t);
+}
+
+// Testes de colisão contínuos: cada entidade se move em linha reta da posição
+// do passo anterior até a atual (a corda do arco percorrido na órbita, que se
+// afasta do arco menos de 1 mm por passo a 60 Hz), e os testes devolvem o
+// instante do primeiro contato. Assim os mísseis não atravessam a nave nem os
+// inimigos, mesmo com passos de simulação mais longos.
+
+// Número de esferas de raio "radius" (centros em x, y, z) que colidem com a
+// esfera de centro c e raio "sphere_radius", com os testes em lote de
+// "collisions.h" (várias entidades por instrução SIMD). Usado para descartar
+// rapidamente os testes contínuos quando nada está próximo.
+static int countSphereHits(const float* x, const float* y, const float* z, size_t n,
+                           const glm::vec4& c, float radius, float sphere_radius) {
+    BoundingSphere sphere = { c, sphere_radius };
+    return (int)checkSphereSphereBatch(sphere, x, y, z, radius, n, NULL);
+}
+
+// Maior deslocamento de uma entidade (de prev_* até x, y, z) no último passo
+static float maxStep(const float* x, const float* y, const float* z,
+                     const float* prev_x, const float* prev_y, const float* prev_z, size_t n) {
+    float max_sq = 0.0f;
+    for (size_t i = 0; i < n; ++i) {
+        float dx = x[i] - prev_x[i];
+        float dy = y[i] - prev_y[i];
+        float dz = z[i] - prev_z[i];
+        max_sq = std::max(max_sq, dx*dx + dy*dy + dz*dz);
+    }
+    return std::sqrt(max_sq);
+}
+
+static float stepLength(const glm::vec4& p0, const glm::vec4& p1) {
+    glm::vec4 d = p1 - p0;
+    d.w = 0.0f;
+    return norm(d);
+}
+
+// Confirma com os volumes orientados um contato das esferas envolventes que
+// começa no instante t0: percorre o resto do passo em subpassos menores que o
+// raio da esfera que se move ("travel" é o deslocamento relativo no passo) e
+// devolve em t_out o primeiro instante em que overlaps(t) acusa contato
+template <typename Overlaps>
+static bool refineHit(float t0, float travel, float radius, const Overlaps& overlaps, float& t_out) {
+    int steps = (int)std::ceil(travel * (1.0f - t0) / radius);
+    steps = std::min(std::max(steps, 1), maxRefineSteps);
+
+    for (int k = 0; k <= steps; ++k) {
+        float t = t0 + (1.0f - t0) * k / steps;
+        if (overlaps(t)) {
+            t_out = t;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Teste contínuo da esfera "sphere" (de sphere.center até "end") contra uma
+// nave (a do jogador ou um inimigo) que vai de pos0 a pos1, virada de fwd0
+// para fwd1. Com volumes ajustados, cada volume só é testado depois que o
+// anterior acusou contato: esfera em volta da origem, esfera envolvente,
+// cápsula e, se houver, os triângulos da malha.
+static bool sweptShipHit(const EntityBounds& bounds, const glm::vec4& pos0, const glm::vec4& fwd0,
+                         const glm::vec4& pos1, const glm::vec4& fwd1,
+                         const BoundingSphere& sphere, const glm::vec4& end, float& t_out) {
+    if (!bounds.fitted) {
+        BoundingSphere ship = { pos0, AIRCRAFT_SPHERE_RADIUS };
+        return checkSweptSphereSphereCollision(sphere, end, ship, pos1, t_out);
+    }
+
+    // A esfera em volta da origem (de raio "reach") não depende da orientação
+    // e descarta a maior parte dos candidatos sem montar os referenciais
+    BoundingSphere around = { pos0, bounds.reach };
+    float t0;
+    if (!checkSweptSphereSphereCollision(sphere, end, around, pos1, t0))
+        return false;
+
+    const MeshBounds& local = bounds.local;
+    BoundingSphere ship = { Sim_OrbitFrame(pos0, fwd0) * local.sphere.center, local.sphere.radius };
+    if (!checkSweptSphereSphereCollision(sphere, end, ship, Sim_OrbitFrame(pos1, fwd1) * local.sphere.center, t0))
+        return false;
+
+    float travel = stepLength(sphere.center, end) + stepLength(pos0, pos1);
+    return refineHit(t0, travel, sphere.radius, [&](float t) {
+        glm::mat4 frame = Sim_OrbitFrame(pos0 + t * (pos1 - pos0), fwd0 + t * (fwd1 - fwd0));
+        BoundingCapsule capsule = { frame * local.capsule.a, frame * local.capsule.b, local.capsule.radius };
+        BoundingSphere moving = { sphere.center + t * (end - sphere.center), sphere.radius };
+        if (!checkCapsuleSphereCollision(capsule, moving))
+            return false;
+        return !bounds.mesh || MeshCollider_OverlapSphere(*bounds.mesh, frame, moving.center, moving.radius);
+    }, t_out);
+}
+
+// Esfera envolvente da nave no início do passo, e o centro dela no fim
+static BoundingSphere aircraftSweptSphere(const GameState& state, glm::vec4& end) {
+    const EntityBounds& bounds = state.aircraftBounds;
+    if (!bounds.fitted) {
+        end = state.aircraftPosition;
+        BoundingSphere sphere = { state.aircraftPositionPrev, AIRCRAFT_SPHERE_RADIUS };
+        return sphere;
+    }
+
+    end = Sim_OrbitFrame(state.aircraftPosition, state.aircraftForward) * bounds.local.sphere.center;
+    BoundingSphere sphere = { Sim_OrbitFrame(state.aircraftPositionPrev, state.aircraftForwardPrev) * bounds.local.sphere.center,
+                              bounds.local.sphere.radius };
+    return sphere;
+}
+
+// Teste contínuo da esfera "sphere" (de sphere.center até "end") contra a nave
+static bool sweptAircraftHit(const GameState& state, const BoundingSphere& sphere, const glm::vec4& end, float& t_out) {
+    return sweptShipHit(state.aircraftBounds, state.aircraftPositionPrev, state.aircraftForwardPrev,
+                        state.aircraftPosition, state.aircraftForward, sphere, end, t_out);
+}
+
+// Chama hit(i, t) para cada inimigo vivo i (índice atual) que a esfera
+// "sphere", indo de sphere.center até "end", toca durante o passo, no
+// instante t. Os testes contínuos só são feitos com os inimigos cuja posição
+// atual está a até "reach" de "end": a distância máxima em que ainda poderia
+// haver contato, dado o maior deslocamento dos inimigos no passo
+// (enemy_step). Com a grade, somente as células próximas são consultadas; os
+// inimigos não se movem durante as colisões, então as posições guardadas nela
+// continuam valendo.
+template <typename Hit>
+static void forEachEnemyHit(const GameState& state, bool use_grid, const BoundingSphere& sphere, const glm::vec4& end,
+                            float enemy_step, const Hit& hit) {
+    const EnemyArray& enemies = state.enemies;
+    const EntityBounds& bounds = state.aircraftBounds;
+    float enemy_reach = bounds.fitted ? bounds.reach : AIRCRAFT_SPHERE_RADIUS;
+    float reach = enemy_reach + sphere.radius + stepLength(sphere.center, end) + enemy_step;
+
+    auto test = [&](int i) {
+        float t;
+        if (sweptShipHit(bounds, enemies.prevPosition(i), enemies.prevForward(i),
+                         enemies.position(i), enemies.forward(i), sphere, end, t))
+            hit(i, t);
+    };
+
+    if (use_grid) {
+        const SphereGrid& grid = state.enemyGrid;
+        SphereGrid_Query(grid, end, reach, [&](unsigned int k) {
+            int i = state.enemies.indexOf[grid.items[k]];
+            if (i >= 0)
+                test(i);
+        });
+    } else if (countSphereHits(enemies.x.data(), enemies.y.data(), enemies.z.data(), enemies.size(),
+                               end, 0.0f, reach) > 0) {
+        for (size_t i = 0; i < enemies.size(); ++i)
+            test((int)i);
+    }
+}
+
+// Os asteroides não giram (são desenhados somente com translação e escala),
+// então o referencial deles é a própria posição
+static glm::vec4 asteroidOffset(const AsteroidArray& asteroids, size_t i) {
+    return glm::vec4(asteroids.x[i], asteroids.y[i], asteroids.z[i], 0.0f);
+}
+
+// Teste contínuo da esfera "sphere" (de sphere.center até "end") contra o
+// asteroide i
+static bool sweptAsteroidHit(const GameState& state, size_t i, const BoundingSphere& sphere, const glm::vec4& end,
+                             float& t_out) {
+    const EntityBounds& bounds = state.asteroidBounds;
+    if (!bounds.fitted)
+        return checkSweptCylinderSphereCollision(getAsteroidBoundingCylinder(state.randomAsteroids.position(i)),
+                                                 sphere, end, t_out);
+
+    glm::vec4 offset = asteroidOffset(state.randomAsteroids, i);
+    BoundingSphere asteroid = { bounds.local.sphere.center + offset, bounds.local.sphere.radius };
+    float t0;
+    if (!checkSweptSphereSphereCollision(sphere, end, asteroid, asteroid.center, t0))
+        return false;
+
+    BoundingOBB box = bounds.local.box;
+    box.center += offset;
+    return refineHit(t0, stepLength(sphere.center, end), sphere.radius, [&](float t) {
+        BoundingSphere moving = { sphere.center + t * (end - sphere.center), sphere.radius };
+        return checkOBBSphereCollision(box, moving);
+    }, t_out);
+}
+
+// Monta a BVH do campo de asteroides com as caixas dos cilindros (ou, com
+// volumes ajustados, das caixas orientadas). Os ids dos asteroides (usados
+// somente pela BVH) são renumerados, para que a árvore não guarde asteroides
+// já destruídos.
+static void buildAsteroidBvh(GameState& state) {
+    AsteroidArray& asteroids = state.randomAsteroids;
+    asteroids.renumber();
+
+    // Centro (relativo à posição) e meias medidas da caixa de um asteroide
+    float center[3] = { 0.0f, 0.0f, 0.0f };
+    float half[3] = { ASTEROID_CYLINDER_RADIUS, ASTEROID_CYLINDER_HEIGHT / 2.0f, ASTEROID_CYLINDER_RADIUS };
+    if (state.asteroidBounds.fitted) {
+        const BoundingOBB& box = state.asteroidBounds.local.box;
+        for (int a = 0; a < 3; ++a) {
+            center[a] = box.center[a];
+            half[a] = 0.0f;
+            for (int k = 0; k < 3; ++k)
+                half[a] += std::fabs(box.axis[k][a]) * box.halfSize[k];
+        }
+    }
+
+    std::vector<BvhBox> boxes(asteroids.size());
+    for (size_t i = 0; i < asteroids.size(); ++i) {
+        float c[3] = { asteroids.x[i] + center[0], asteroids.y[i] + center[1], asteroids.z[i] + center[2] };
+        for (int a = 0; a < 3; ++a) {
+            boxes[i].min[a] = c[a] - half[a];
+            boxes[i].max[a] = c[a] + half[a];
+        }
+    }
+    Bvh_Build(state.asteroidBvh, boxes.data(), boxes.size());
+}
+
+static void setEntityBounds(EntityBounds& bounds, const MeshBounds& local) {
+    glm::vec4 center = local.sphere.center;
+    center.w = 0.0f;
+
+    bounds.fitted = true;
+    bounds.local = local;
+    bounds.reach = norm(center) + local.sphere.radius;
+}
+
+void Sim_SetMeshBounds(GameState& state, const MeshBounds& aircraft, const MeshBounds& asteroid) {
+    setEntityBounds(state.aircraftBounds, aircraft);
+    setEntityBounds(state.asteroidBounds, asteroid);
+
+    // As caixas da BVH dependem dos volumes dos asteroides
+    buildAsteroidBvh(state);
+}
+
+void Sim_SetAircraftMesh(GameState& state, const MeshCollider* mesh) {
+    state.aircraftBounds.mesh = mesh;
+}
+
+// Chama hit(i, t) para cada asteroide i (índice atual) que a esfera "sphere",
+// indo de sphere.center até "end", toca durante o passo, no instante t. Os
+// candidatos vêm da BVH (ou, com poucos asteroides, são todos, o que custa
+// menos). Em cada instante, o teste do cilindro soma os raios e as alturas
+// separadamente, então a região aceita cabe na caixa do cilindro aumentada de
+// sphere.radius em cada eixo; com volumes ajustados, o contato exige tocar a
+// caixa orientada, contida na caixa guardada na BVH.
+template <typename Hit>
+static void forEachAsteroidHit(const GameState& state, const BoundingSphere& sphere, const glm::vec4& end,
+                               const Hit& hit) {
+    const AsteroidArray& asteroids = state.randomAsteroids;
+    const glm::vec4& p0 = sphere.center;
+    const glm::vec4& p1 = end;
+
+    if (asteroids.size() < asteroidBvhMinAsteroids) {
+        // Prefiltro em lote: a esfera no meio do segmento, aumentada de meio
+        // deslocamento, contém a esfera em todo o passo
+        BoundingSphere swept = { 0.5f * (p0 + p1), sphere.radius + 0.5f * stepLength(p0, p1) };
+        unsigned int mask[COLLISION_MASK_WORDS(asteroidBvhMinAsteroids)];
+        size_t candidates;
+        if (state.asteroidBounds.fitted) {
+            // Esferas envolventes dos asteroides, deslocadas da posição deles
+            const BoundingSphere& local = state.asteroidBounds.local.sphere;
+            swept.center -= local.center - glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+            candidates = checkSphereSphereBatch(swept, asteroids.x.data(), asteroids.y.data(), asteroids.z.data(),
+                                                local.radius, asteroids.size(), mask);
+        } else {
+            candidates = checkCylinderSphereBatch(swept, asteroids.x.data(), asteroids.y.data(), asteroids.z.data(),
+                                                  ASTEROID_CYLINDER_RADIUS, ASTEROID_CYLINDER_HEIGHT, asteroids.size(), mask);
+        }
+        if (candidates == 0)
+            return;
+
+        unsigned int list[asteroidBvhMinAsteroids];
+        size_t count = collisionHitList(mask, asteroids.size(), list);
+        for (size_t k = 0; k < count; ++k) {
+            float t;
+            if (sweptAsteroidHit(state, list[k], sphere, end, t))
+                hit((int)list[k], t);
+        }
+        return;
+    }
+
+    // Os deslocamentos em um passo são curtos, então a caixa do segmento
+    // inteiro descarta quase tanto quanto o teste do segmento, e custa menos
+    BvhBox box;
+    float a[3] = { p0.x, p0.y, p0.z };
+    float b[3] = { p1.x, p1.y, p1.z };
+    for (int k = 0; k < 3; ++k) {
+        box.min[k] = std::min(a[k], b[k]) - sphere.radius;
+        box.max[k] = std::max(a[k], b[k]) + sphere.radius;
+    }
+
+    Bvh_QueryBox(state.asteroidBvh, box, [&](unsigned int id) {
+        int i = asteroids.indexOf[id];
+        float t;
+        if (i >= 0 && sweptAsteroidHit(state, i, sphere, end, t))
+            hit(i, t);
+    });
+}
+
+// Chama hit(type, target, t) para cada alvo que o míssil i toca durante o
+// passo: inimigos (mísseis da nave) ou a nave (mísseis dos inimigos), e
+// asteroides. Somente lê o estado, e pode ser chamada de várias threads.
+template <typename Hit>
+static void forEachMissileHit(const GameState& state, size_t i, bool use_enemy_grid, float enemy_step, const Hit& hit) {
+    const MissilePool& missiles = state.missiles;
+    BoundingSphere missileSphere = { missiles.prevPosition(i), missileRadius };
+    glm::vec4 missilePos = missiles.position(i);
+
+    if (missiles.ownerId[i] == 0) { // Míssil da Nave -> Colide com Inimigos
+        forEachEnemyHit(state, use_enemy_grid, missileSphere, missilePos, enemy_step,
+                        [&](int j, float t) { hit(COLLISION_MISSILE_ENEMY, j, t); });
+    } else { // Míssil do Inimigo -> Colide com a Nave
+        float t;
+        if (sweptAircraftHit(state, missileSphere, missilePos, t))
+            hit(COLLISION_MISSILE_AIRCRAFT, 0, t);
+    }
+
+    forEachAsteroidHit(state, missileSphere, missilePos,
+                       [&](int j, float t) { hit(COLLISION_MISSILE_ASTEROID, j, t); });
+}
+
+// Ordem dos contatos de um míssil: o de menor instante primeiro e, no mesmo
+// instante, o de maior índice (para que o resultado não dependa da ordem em
+// que os candidatos são visitados). O tipo só desempata contatos com o mesmo
+// índice, que são de alvos diferentes e não competem entre si.
+static bool missileHitLess(const CollisionEvent& a, const CollisionEvent& b) {
+    if (a.t != b.t)
+        return a.t < b.t;
+    if (a.target != b.target)
+        return a.target > b.target;
+    return a.type < b.type;
+}
+
+static void pushCollision(GameState& state, unsigned int type, unsigned int source, unsigned int target, float t) {
+    CollisionEvent event = { type, source, target, t };
+    state.collisionEvents.push_back(event);
+}
+
+// Função que testa as colisões. É feita em três etapas:
+//   1. Detecção: os testes só leem o estado e guardam cada contato em
+//      state.collisionEvents (os dos mísseis, em paralelo);
+//   2. Resolução: os contatos são aplicados em uma ordem fixa (dano, vida,
+//      entidades marcadas para remoção);
+//   3. Compactação: cada vetor de entidades perde as marcadas de uma vez
+//      (SwapCompact()), em vez de uma troca com o último elemento no meio
+//      dos testes.
+static void processCollisions(GameState& state, JobSystem* jobs) {
+    EnemyArray& enemies = state.enemies;
+    AsteroidArray& asteroids = state.randomAsteroids;
+    MissilePool& missiles = state.missiles;
+    std::vector<CollisionEvent>& events = state.collisionEvents;
+
+    // Com muitos mísseis e inimigos, cada míssil testa somente os inimigos
+    // das células próximas (broadphase na esfera) em vez de todos
+    bool use_enemy_grid = enemies.size() >= sphereGridMinTargets && missiles.size() >= sphereGridMinMissiles;
+
+    if (use_enemy_grid) {
+        SphereGrid& grid = state.enemyGrid;
+        SphereGrid_Build(grid, enemies.x.data(), enemies.y.data(), enemies.z.data(), enemies.size());
+        for (size_t k = 0; k < grid.items.size(); ++k)
+            grid.items[k] = enemies.id[grid.items[k]];
+    }
+
+    // Os asteroides não se movem: a BVH só é montada de novo se algum foi
+    // acrescentado depois dela, ou se mais da metade dos que ela guarda já foi
+    // destruída
+    size_t bvh_items = Bvh_ItemCount(state.asteroidBvh);
+    if (bvh_items != asteroids.indexOf.size() || 2 * asteroids.size() < bvh_items)
+        buildAsteroidBvh(state);
+
+    float enemy_step = maxStep(enemies.x.data(), enemies.y.data(), enemies.z.data(),
+                               enemies.prev_x.data(), enemies.prev_y.data(), enemies.prev_z.data(), enemies.size());
+
+    events.clear();
+
+    // =======================================================
+    // Colisão Nave vs. Inimigo (ESFERA-ESFERA)
+    // =======================================================
+
+    // Esfera envolvente da nave, do início ao fim do passo
+    glm::vec4 aircraftEnd;
+    BoundingSphere aircraftSphere = aircraftSweptSphere(state, aircraftEnd);
+
+    forEachEnemyHit(state, use_enemy_grid, aircraftSphere, aircraftEnd, enemy_step,
+                    [&](int i, float t) { pushCollision(state, COLLISION_AIRCRAFT_ENEMY, 0, i, t); });
+
+    // =======================================================
+    // Coletar Checkpoints (RAIO-ESFERA)
+    // =======================================================
+
+    // A nave precisa ter se movido para que o raio de trajetória seja válido
+    if (state.aircraftPositionPrev != state.aircraftPosition) {
+
+        // 1. Define o Raio (Linha de Movimento da Nave)
+        Ray trajectoryRay;
+        trajectoryRay.origin = state.aircraftPositionPrev; // Posição anterior
+
+        glm::vec4 movement_vector = state.aircraftPosition - state.aircraftPositionPrev;
+        movement_vector.w = 0.0f;
+
+        trajectoryRay.direction = normalizedVec(movement_vector);
+        float movement_distance = norm(movement_vector);
+
+        for (size_t i = 0; i < state.checkpoints.size(); ++i) {
+            BoundingSphere checkpointSphere = getCheckpointBoundingSphere(state.checkpoints[i]);
+
+            float t_hit; // Distância do ponto de colisão
+
+            // O ponto de intersecção (t_hit) precisa estar *dentro* do
+            // segmento de movimento
+            if (checkRaySphereCollision(trajectoryRay, checkpointSphere, t_hit)
+                && t_hit >= 0.0f && t_hit <= movement_distance)
+                pushCollision(state, COLLISION_CHECKPOINT, 0, (unsigned int)i, t_hit / movement_distance);
+        }
+    }
+
+    // =======================================================
+    // Colisão Nave vs. TODOS Asteroides (CILINDRO-ESFERA)
+    // =======================================================
+
+    forEachAsteroidHit(state, aircraftSphere, aircraftEnd,
+                       [&](int i, float t) { pushCollision(state, COLLISION_AIRCRAFT_ASTEROID, 0, i, t); });
+
+    // =======================================================
+    // Colisão Missil vs. Nave/Inimigo e Asteroides
+    // =======================================================
+
+    // Em paralelo: cada míssil conta seus contatos, e depois os escreve a
+    // partir da sua posição em "events" (soma dos contatos dos mísseis
+    // anteriores). Cada thread escreve somente no trecho dos seus mísseis, e
+    // o resultado não depende da divisão entre as threads.
+    std::vector<unsigned int>& first = state.missileEvents;
+    first.assign(missiles.size() + 1, 0);
+
+    parallelRange(jobs, missiles.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            unsigned int hits = 0;
+            forEachMissileHit(state, i, use_enemy_grid, enemy_step,
+                              [&](unsigned int, unsigned int, float) { ++hits; });
+            first[i + 1] = hits;
+        }
+    });
+
+    first[0] = (unsigned int)events.size();
+    for (size_t i = 0; i < missiles.size(); ++i)
+        first[i + 1] += first[i];
+    events.resize(first[missiles.size()]);
+
+    parallelRange(jobs, missiles.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            if (first[i] == first[i + 1])
+                continue;
+            CollisionEvent* out = &events[first[i]];
+            forEachMissileHit(state, i, use_enemy_grid, enemy_step,
+                              [&](unsigned int type, unsigned int target, float t) {
+                                  CollisionEvent event = { type, (unsigned int)i, target, t };
+                                  *out++ = event;
+                              });
+            std::sort(&events[first[i]], out, missileHitLess);
+        }
+    });
+
+    // =======================================================
+    // Resolução dos contatos
+    // =======================================================
+
+    std::vector<unsigned char>& enemyDead = state.enemyDead;
+    std::vector<unsigned char>& checkpointDead = state.checkpointDead;
+    std::vector<unsigned char>& asteroidDead = state.asteroidDead;
+    std::vector<unsigned char>& missileDead = state.missileDead;
+    enemyDead.assign(enemies.size(), 0);
+    checkpointDead.assign(state.checkpoints.size(), 0);
+    asteroidDead.assign(asteroids.size(), 0);
+    missileDead.assign(missiles.size(), 0);
+
+    size_t enemy_kills = 0, checkpoint_kills = 0, asteroid_kills = 0, missile_kills = 0;
+    bool asteroid_damage = false;
+
+    // Contatos da nave: todos os inimigos e asteroides tocados são
+    // destruídos. Cada inimigo tira uma vida; os asteroides, uma vida no total.
+    for (size_t k = 0; k < first[0]; ++k) {
+        const CollisionEvent& event = events[k];
+        switch (event.type) {
+        case COLLISION_AIRCRAFT_ENEMY:
+            damageAircraft(state);
+            enemyDead[event.target] = 1;
+            ++enemy_kills;
+            break;
+        case COLLISION_CHECKPOINT:
+            checkpointDead[event.target] = 1;
+            ++checkpoint_kills;
+
+            // Recuperar vida ao pegar um checkpoint
+            if (state.aircraftLife < MAX_LIFE) {
+                 state.aircraftLife++;
+            }
+            break;
+        case COLLISION_AIRCRAFT_ASTEROID:
+            if (!asteroid_damage)
+                damageAircraft(state);
+            asteroid_damage = true;
+            asteroidDead[event.target] = 1;
+            Bvh_Remove(state.asteroidBvh, asteroids.id[event.target]);
+            ++asteroid_kills;
+            break;
+        }
+    }
+
+    // Cada míssil destrói no máximo um inimigo (ou atinge a nave) e um
+    // asteroide no passo: em cada um dos dois, o primeiro que toca e que
+    // ainda não foi destruído. Os mísseis são resolvidos de trás para frente,
+    // sempre na mesma ordem.
+    for (size_t i = missiles.size(); i-- > 0;) {
+        bool target_hit = false, asteroid_hit = false;
+        for (size_t k = first[i]; k < first[i + 1]; ++k) {
+            const CollisionEvent& event = events[k];
+            if (event.type == COLLISION_MISSILE_ENEMY) {
+                if (target_hit || enemyDead[event.target])
+                    continue;
+                enemyDead[event.target] = 1;
+                ++enemy_kills;
+                target_hit = true;
+            } else if (event.type == COLLISION_MISSILE_AIRCRAFT) {
+                if (target_hit)
+                    continue;
+                damageAircraft(state);
+                target_hit = true;
+            } else {
+                if (asteroid_hit || asteroidDead[event.target])
+                    continue;
+                asteroidDead[event.target] = 1;
+                Bvh_Remove(state.asteroidBvh, asteroids.id[event.target]);
+                ++asteroid_kills;
+                asteroid_hit = true;
+            }
+        }
+        if (target_hit || asteroid_hit) {
+            missileDead[i] = 1;
+            ++missile_kills;
+        }
+    }
+
+    // =======================================================
+    // Compactação
+    // =======================================================
+
+    if (enemy_kills > 0)
+        enemies.compact(enemyDead);
+    if (checkpoint_kills > 0) {
+        std::vector<glm::vec4>& checkpoints = state.checkpoints;
+        checkpoints.resize(SwapCompact(checkpointDead, checkpoints.size(), [](size_t) {},
+                                       [&](size_t from, size_t to) { checkpoints[to] = checkpoints[from]; }));
+    }
+    if (asteroid_kills > 0)
+        asteroids.compact(asteroidDead);
+    if (missile_kills > 0)
+        missiles.compact(missileDead);
+}
+
+glm::vec4 normalizedVec(glm::vec4 v) {
+    float n = norm(v);
+    v = v / n;
+    v.w = 0.0f;
+
+    return v;
+}
+
+// inicia os checkpoints no jogo
+static void initCheckpoints(GameState& state) {
+    state.checkpoints.clear();
+
+    glm::vec4 center = moon_position;
+
+    state.checkpoints.push_back(center + glm::vec4(orbitDistance, 0.0f, 0.0f, 1.0f));
+    state.checkpoints.push_back(center + glm::vec4(-orbitDistance, 0.0f, 0.0f, 1.0f));
+    state.checkpoints.push_back(center + glm::vec4(0.0f, orbitDistance, 0.0f, 1.0f));
+    state.checkpoints.push_back(center + glm::vec4(0.0f, -orbitDistance, 0.0f, 1.0f));
+    state.checkpoints.push_back(center + glm::vec4(0.0f, 0.0f, -orbitDistance, 1.0f));
+}
+
+// Função que inicializa asteroides em posições aleatórias na órbita
+static void initRandomAsteroids(GameState& state) {
+    state.randomAsteroids.clear();
+    glm::vec4 center = moon_position;
+
+    for (int i = 0; i < numRandomAsteroids; ++i) {
+        glm::vec4 randomDir = glm::vec4(
+            randomFloat(state, -1.0f, 1.0f),
+            randomFloat(state, -1.0f, 1.0f),
+            randomFloat(state, -1.0f, 1.0f),
+            0.0f
+        );
+        randomDir = normalizedVec(randomDir);
+
+        state.randomAsteroids.push_back(center + randomDir * orbitDistance);
+    }
+
+    buildAsteroidBvh(state);
+}
+
+
+// função de tiro do missil
+static void fireMissile(GameState& state, const glm::vec4& startPos, const glm::vec4& direction, int ownerId) {
+    glm::vec4 forward = direction;
+    forward.w = 0.0f;
+
+    MissileHandle handle = state.missiles.spawn(startPos, forward, (unsigned char)ownerId);
+
+    // Auto-destruição após missileLifespan segundos
+    if (state.missiles.isAlive(handle))
+        scheduleTimer(state, missileLifespan, TIMER_MISSILE_EXPIRE, handle.slot, handle.generation);
+}
+
+// atualiza a movimentação do missil
+static void updateMissiles(GameState& state, float delta_t, JobSystem* jobs) {
+    MissilePool& missiles = state.missiles;
+
+    // Angulo de avanço na esfera (igual para todos os mísseis). A direção
+    // FORWARD gira junto com a posição para acompanhar a curva.
+    float angle_of_advance = missileSpeed * delta_t * 0.05f;
+    parallelRange(jobs, missiles.size(), [&](size_t begin, size_t end) {
+        Orbit_Advance(&missiles.x[begin], &missiles.y[begin], &missiles.z[begin],
+                      &missiles.fx[begin], &missiles.fy[begin], &missiles.fz[begin], end - begin,
+                      moon_position, orbitDistance, angle_of_advance);
+    });
+}
+
+// Interpola entre duas posições na órbita (mesma distância da lua), mantendo
+// o resultado sobre a órbita.
+glm::vec4 Sim_InterpolateOrbitPosition(const glm::vec4& prev, const glm::vec4& curr, float alpha) {
+    glm::vec4 relative = (prev + (curr - prev) * alpha) - moon_position;
+    relative.w = 0.0f;
+
+    float n = norm(relative);
+    if (n == 0.0f)
+        return curr;
+
+    float orbit_distance = norm(curr - moon_position);
+    glm::vec4 result = moon_position + relative * (orbit_distance / n);
+    result.w = 1.0f;
+    return result;
+}
+
+// Interpola entre duas direções unitárias
+glm::vec4 Sim_InterpolateDirection(const glm::vec4& prev, const glm::vec4& curr, float alpha) {
+    glm::vec4 dir = prev + (curr - prev) * alpha;
+    dir.w = 0.0f;
+
+    if (norm(dir) < 1e-6f)
+        return curr;
+
+    return normalizedVec(dir);
+}
+
+glm::mat4 Sim_OrbitFrame(const glm::vec4& position, const glm::vec4& forward) {
+    glm::vec4 up = normalizedVec(position - moon_position);
+    glm::vec4 front = normalizedVec(forward - dotproduct(forward, up) * up);
+    glm::vec4 right = normalizedVec(crossproduct(up, front));
+
+    glm::mat4 frame(1.0f);
+    frame[0] = right;
+    frame[1] = up;
+    frame[2] = front;
+    frame[3] = position;
+    return frame;
+}
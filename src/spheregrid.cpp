@@ -0,0 +1,166 @@
+// Grade espacial sobre a esfera. Veja "spheregrid.h".
+#include <cmath>
+#include <algorithm>
+
+#include "spheregrid.h"
+
+static const float quarterPi = 0.78539816f;
+
+// Margem angular das consultas, para que erros de arredondamento nunca
+// excluam uma célula
+static const float angleEpsilon = 1e-4f;
+
+// Eixos da face f: a face é perpendicular ao eixo k (lado positivo se f for
+// par), e suas coordenadas u, v são medidas ao longo dos eixos i e j
+static void SphereGrid_FaceAxes(int f, int& i, int& j, int& k, float& sign)
+{
+    k = f / 2;
+    i = (k + 1) % 3;
+    j = (k + 2) % 3;
+    sign = (f % 2 == 0) ? 1.0f : -1.0f;
+}
+
+// Coluna (ou linha) da célula de ângulo "angle" em [-pi/4, pi/4]
+static int SphereGrid_Coord(const SphereGrid& grid, float angle)
+{
+    int c = (int)std::floor((angle / quarterPi + 1.0f) * 0.5f * grid.resolution);
+    return std::min(std::max(c, 0), grid.resolution - 1);
+}
+
+void SphereGrid_Init(SphereGrid& grid, const glm::vec4& center, int resolution)
+{
+    grid.center = center;
+    grid.resolution = std::max(resolution, 1);
+    grid.cellStart.assign(SPHEREGRID_FACES * grid.resolution * grid.resolution + 1, 0);
+    grid.cellOf.clear();
+    grid.items.clear();
+    grid.x.clear(); grid.y.clear(); grid.z.clear();
+}
+
+unsigned int SphereGrid_Cell(const SphereGrid& grid, float x, float y, float z)
+{
+    float w[3] = { x - grid.center.x, y - grid.center.y, z - grid.center.z };
+    float a[3] = { std::fabs(w[0]), std::fabs(w[1]), std::fabs(w[2]) };
+
+    // Face do eixo de maior coordenada
+    int k = 0;
+    if (a[1] > a[k]) k = 1;
+    if (a[2] > a[k]) k = 2;
+    int f = 2 * k + (w[k] < 0.0f ? 1 : 0);
+
+    int i = (k + 1) % 3;
+    int j = (k + 2) % 3;
+    int u = SphereGrid_Coord(grid, std::atan2(w[i], a[k]));
+    int v = SphereGrid_Coord(grid, std::atan2(w[j], a[k]));
+
+    return (unsigned int)((f * grid.resolution + v) * grid.resolution + u);
+}
+
+void SphereGrid_Build(SphereGrid& grid, const float* x, const float* y, const float* z, size_t n)
+{
+    if (grid.resolution <= 0)
+        SphereGrid_Init(grid, grid.center, 1);
+
+    size_t cells = grid.cellStart.size() - 1;
+    grid.cellOf.resize(n);
+    grid.items.resize(n);
+    grid.x.resize(n); grid.y.resize(n); grid.z.resize(n);
+
+    // Ordenação por contagem: conta as entidades de cada célula, calcula o
+    // início de cada célula e distribui as entidades em ordem de índice
+    std::fill(grid.cellStart.begin(), grid.cellStart.end(), 0u);
+    for (size_t e = 0; e < n; ++e) {
+        unsigned int cell = SphereGrid_Cell(grid, x[e], y[e], z[e]);
+        grid.cellOf[e] = cell;
+        ++grid.cellStart[cell + 1];
+    }
+
+    for (size_t c = 0; c < cells; ++c)
+        grid.cellStart[c + 1] += grid.cellStart[c];
+
+    // cellStart[c] serve de cursor de escrita da célula c, e ao final passa a
+    // valer o início da célula c + 1; o deslocamento abaixo o restaura
+    for (size_t e = 0; e < n; ++e) {
+        unsigned int k = grid.cellStart[grid.cellOf[e]]++;
+        grid.items[k] = (unsigned int)e;
+        grid.x[k] = x[e]; grid.y[k] = y[e]; grid.z[k] = z[e];
+    }
+
+    for (size_t c = cells; c > 0; --c)
+        grid.cellStart[c] = grid.cellStart[c - 1];
+    grid.cellStart[0] = 0;
+}
+
+int SphereGrid_Ranges(const SphereGrid& grid, const glm::vec4& p, float radius,
+                      SphereGridRange ranges[SPHEREGRID_FACES])
+{
+    float d[3] = { p.x - grid.center.x, p.y - grid.center.y, p.z - grid.center.z };
+    float dist = std::sqrt(d[0]*d[0] + d[1]*d[1] + d[2]*d[2]);
+
+    // Ângulo (visto do centro) da esfera consultada: toda entidade que a toca
+    // está a no máximo "cap" radianos da direção de p
+    bool everything = radius >= dist;
+    float sin_cap = 1.0f;
+    float cap = 3.14159265f;
+    if (!everything) {
+        sin_cap = radius / dist;
+        cap = std::asin(sin_cap) + angleEpsilon;
+        sin_cap = std::sin(std::min(cap, 1.57079632f));
+        for (int a = 0; a < 3; ++a)
+            d[a] /= dist;
+    }
+
+    // As direções de uma face estão a no máximo acos(1/sqrt(3)) do eixo dela
+    const float faceAngle = 0.95531662f;
+
+    int count = 0;
+    for (int f = 0; f < SPHEREGRID_FACES; ++f) {
+        int i, j, k;
+        float sign;
+        SphereGrid_FaceAxes(f, i, j, k, sign);
+
+        SphereGridRange range;
+        range.face = f;
+        range.u0 = 0; range.u1 = grid.resolution - 1;
+        range.v0 = 0; range.v1 = grid.resolution - 1;
+
+        if (!everything) {
+            if (faceAngle + cap < 3.14159265f && sign * d[k] < std::cos(faceAngle + cap))
+                continue;
+
+            // Ângulo de cada eixo da face (u com i, v com j), como em
+            // SphereGrid_Cell(). As direções com esse ângulo igual a phi formam
+            // um meio grande círculo, que a calota de p toca se
+            // rho * |sin(phi - phi_p)| <= sin(cap), com rho o comprimento de
+            // d projetado no plano dos dois eixos.
+            bool empty = false;
+            int axes[2] = { i, j };
+            int lo[2], hi[2];
+            for (int a = 0; a < 2; ++a) {
+                float rho = std::sqrt(d[axes[a]] * d[axes[a]] + d[k] * d[k]);
+                float angle_lo = -quarterPi, angle_hi = quarterPi;
+                if (rho > sin_cap) {
+                    float center_angle = std::atan2(d[axes[a]], sign * d[k]);
+                    float half = std::asin(sin_cap / rho) + angleEpsilon;
+                    angle_lo = std::max(angle_lo, center_angle - half);
+                    angle_hi = std::min(angle_hi, center_angle + half);
+                }
+                if (angle_lo > angle_hi) {
+                    empty = true;
+                    break;
+                }
+                lo[a] = SphereGrid_Coord(grid, angle_lo);
+                hi[a] = SphereGrid_Coord(grid, angle_hi);
+            }
+            if (empty)
+                continue;
+
+            range.u0 = lo[0]; range.u1 = hi[0];
+            range.v0 = lo[1]; range.v1 = hi[1];
+        }
+
+        ranges[count++] = range;
+    }
+
+    return count;
+}
@@ -1,6 +1,7 @@
 // Based on http://hamelot.io/visualization/opengl-text-without-any-external-libraries/
 //   and on https://github.com/rougier/freetype-gl
 #include <string>
+#include <vector>
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
@@ -10,6 +11,7 @@
 
 #include "utils.h"
 #include "dejavufont.h"
+#include "renderstats.h"
 
 GLuint CreateGpuProgram(GLuint vertex_shader_id, GLuint fragment_shader_id); // Função definida em main.cpp
 
@@ -87,10 +89,35 @@ GLuint textVBO;
 GLuint textprogram_id;
 GLuint texttexture_id;
 
+// Tabela de acesso direto codepoint -> glyph, construída em
+// TextRendering_Init(). A fonte possui somente caracteres ASCII.
+const size_t textglyphs_count = 128;
+texture_glyph_t* textglyphs[textglyphs_count];
+
+// Vértices (x, y, s, t) de todos os caracteres impressos no quadro atual, e
+// capacidade atual do VBO (em floats). Veja TextRendering_Flush().
+std::vector<float> textvertices;
+size_t textvbo_capacity = 0;
+
+// VBO (e VAO) dos textos retidos, com a geometria de todos eles concatenada.
+// Só é reenviado à GPU quando algum texto retido muda. Veja
+// TextRendering_PrintStringRetained().
+GLuint textretainedVAO;
+GLuint textretainedVBO;
+GLsizei textretained_vertex_count = 0;
+
 void TextRendering_Init()
 {
     GLuint sampler;
 
+    for (size_t i = 0; i < textglyphs_count; ++i)
+        textglyphs[i] = 0;
+    for (size_t j = 0; j < dejavufont.glyphs_count; ++j)
+    {
+        if (dejavufont.glyphs[j].codepoint < textglyphs_count)
+            textglyphs[dejavufont.glyphs[j].codepoint] = &dejavufont.glyphs[j];
+    }
+
     glGenBuffers(1, &textVBO);
     glGenVertexArrays(1, &textVAO);
     glGenTextures(1, &texttexture_id);
@@ -126,8 +153,12 @@ void TextRendering_Init()
 
     glBindVertexArray(textVAO);
 
+    // Espaço inicial para 1024 caracteres; o VBO cresce se necessário.
+    textvbo_capacity = 1024 * 24;
+    textvertices.reserve(textvbo_capacity);
+
     glBindBuffer(GL_ARRAY_BUFFER, textVBO);
-    glBufferData(GL_ARRAY_BUFFER, 24 * sizeof(float), NULL, GL_DYNAMIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, textvbo_capacity * sizeof(float), NULL, GL_STREAM_DRAW);
     glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 0, 0);
     glEnableVertexAttribArray(0);
     glCheckError();
@@ -140,33 +171,33 @@ void TextRendering_Init()
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindVertexArray(0);
     glCheckError();
+
+    glGenBuffers(1, &textretainedVBO);
+    glGenVertexArrays(1, &textretainedVAO);
+    glBindVertexArray(textretainedVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, textretainedVBO);
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 0, 0);
+    glEnableVertexAttribArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+    glCheckError();
 }
 
 float textscale = 1.5f;
 
-void TextRendering_PrintString(GLFWwindow* window, const std::string &str, float x, float y, float scale = 1.0f)
+// Calcula a geometria (6 vértices x, y, s, t por caractere) da string "str"
+// posicionada em (x,y), e a adiciona ao final do vetor "out".
+void TextRendering_LayoutString(const char* str, float x, float y, float sx, float sy, std::vector<float>& out)
 {
-    scale *= textscale;
-    int width, height;
-    glfwGetWindowSize(window, &width, &height);
-    float sx = scale / width;
-    float sy = scale / height;
-
-    for (size_t i = 0; i < str.size(); i++)
+    for (size_t i = 0; str[i] != '\0'; i++)
     {
         // Find the glyph for the character we are looking for
-        texture_glyph_t *glyph = 0;
-        for (size_t j = 0; j < dejavufont.glyphs_count; ++j)
-        {
-            if (dejavufont.glyphs[j].codepoint == (uint32_t)str[i])
-            {
-                glyph = &dejavufont.glyphs[j];
-                break;
-            }
-        }
-        if (!glyph) {
+        uint32_t codepoint = (uint32_t)str[i];
+        if (codepoint >= textglyphs_count || !textglyphs[codepoint]) {
             continue;
         }
+        texture_glyph_t *glyph = textglyphs[codepoint];
+
         x += glyph->kerning[0].kerning;
         float x0 = (float) (x + glyph->offset_x * sx);
         float y0 = (float) (y + glyph->offset_y * sy);
@@ -178,37 +209,183 @@ void TextRendering_PrintString(GLFWwindow* window, const std::string &str, float
         float s1 = glyph->s1 - 0.5f/dejavufont.tex_width;
         float t1 = glyph->t1 - 0.5f/dejavufont.tex_height;
 
-        struct {float x, y, s, t;} data[6] = {
-            { x0, y0, s0, t0 },
-            { x0, y1, s0, t1 },
-            { x1, y1, s1, t1 },
-            { x0, y0, s0, t0 },
-            { x1, y1, s1, t1 },
-            { x1, y0, s1, t0 }
+        float data[24] = {
+            x0, y0, s0, t0,
+            x0, y1, s0, t1,
+            x1, y1, s1, t1,
+            x0, y0, s0, t0,
+            x1, y1, s1, t1,
+            x1, y0, s1, t0
         };
 
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        out.insert(out.end(), data, data + 24);
+
+        x += (glyph->advance_x * sx);
+    }
+}
+
+void TextRendering_PrintString(GLFWwindow* window, const std::string &str, float x, float y, float scale = 1.0f)
+{
+    scale *= textscale;
+    int width, height;
+    glfwGetWindowSize(window, &width, &height);
+    float sx = scale / width;
+    float sy = scale / height;
+
+    // O texto é somente acumulado; o desenho acontece em
+    // TextRendering_Flush(), uma vez por quadro.
+    TextRendering_LayoutString(str.c_str(), x, y, sx, sy, textvertices);
+}
+
+// Geometria já calculada de um texto retido, para uma posição e escala.
+struct RetainedText
+{
+    std::string text;
+    float x, y, scale;
+    std::vector<float> vertices;
+};
+
+// Textos retidos impressos no último quadro, na ordem das chamadas. A chamada
+// k de um quadro é comparada somente com a chamada k do quadro anterior: os
+// textos retidos são impressos sempre na mesma ordem (showText()), então basta
+// uma comparação de string por chamada, sem alocação nem busca.
+std::vector<RetainedText> textretained;
+size_t textretained_count = 0;   // Chamadas no quadro atual
+bool textretained_dirty = true;  // O VBO retido precisa ser reenviado
+std::vector<float> textretained_block;
+
+// Tamanho do framebuffer para o qual a geometria foi calculada: quando ele
+// muda, todos os textos retidos são recalculados.
+int textretained_width = 0;
+int textretained_height = 0;
+
+// Versão "retida" de TextRendering_PrintString(), para textos que raramente
+// mudam (instruções, mensagens de fim de jogo, ...). O layout de cada texto é
+// calculado somente quando ele (ou sua posição, escala ou o tamanho do
+// framebuffer) muda em relação ao quadro anterior, e a geometria de todos os
+// textos retidos fica em um VBO próprio, reenviado à GPU somente nesses casos.
+// Veja TextRendering_Flush().
+void TextRendering_PrintStringRetained(GLFWwindow* window, const char* str, float x, float y, float scale = 1.0f)
+{
+    if (textretained_count == 0)
+    {
+        int fb_width, fb_height;
+        glfwGetFramebufferSize(window, &fb_width, &fb_height);
+        if (fb_width != textretained_width || fb_height != textretained_height)
+        {
+            textretained.clear();
+            textretained_width = fb_width;
+            textretained_height = fb_height;
+        }
+    }
+
+    size_t k = textretained_count++;
+    if (k < textretained.size())
+    {
+        const RetainedText& text = textretained[k];
+        if (text.x == x && text.y == y && text.scale == scale && text.text == str)
+            return;
+    }
+    else
+    {
+        textretained.push_back(RetainedText());
+    }
+
+    RetainedText& text = textretained[k];
+    text.text = str;
+    text.x = x;
+    text.y = y;
+    text.scale = scale;
+    text.vertices.clear();
+
+    // Mesma escala de TextRendering_PrintString()
+    int width, height;
+    glfwGetWindowSize(window, &width, &height);
+    float sx = scale * textscale / width;
+    float sy = scale * textscale / height;
+    TextRendering_LayoutString(str, x, y, sx, sy, text.vertices);
+
+    textretained_dirty = true;
+}
+
+// Reenvia ao VBO retido a geometria dos textos retidos, se algum deles mudou
+// (ou deixou de ser impresso) neste quadro
+static void TextRendering_UpdateRetained()
+{
+    if (textretained_count != textretained.size())
+    {
+        textretained.resize(textretained_count);
+        textretained_dirty = true;
+    }
+    textretained_count = 0;
 
-        glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-        glDepthFunc(GL_ALWAYS);
+    if (!textretained_dirty)
+        return;
+    textretained_dirty = false;
+
+    textretained_block.clear();
+    for (size_t i = 0; i < textretained.size(); ++i)
+        textretained_block.insert(textretained_block.end(), textretained[i].vertices.begin(), textretained[i].vertices.end());
+    textretained_vertex_count = (GLsizei)(textretained_block.size() / 4);
+
+    if (textretained_block.empty())
+        return;
+
+    glBindBuffer(GL_ARRAY_BUFFER, textretainedVBO);
+    RenderStats_BufferData(GL_ARRAY_BUFFER, textretained_block.size() * sizeof(float), textretained_block.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+// Desenha todos os caracteres impressos pelas funções TextRendering_Print*()
+// desde a última chamada: os textos retidos, direto do VBO retido, e os demais
+// com uma única chamada de desenho.
+void TextRendering_Flush()
+{
+    TextRendering_UpdateRetained();
+
+    if (textvertices.empty() && textretained_vertex_count == 0)
+        return;
+
+    if (!textvertices.empty())
+    {
         glBindBuffer(GL_ARRAY_BUFFER, textVBO);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, 24 * sizeof(float), data);
+
+        // Se necessário aumentamos o VBO. Caso contrário, "orfanamos" o buffer
+        // anterior para não esperar pelo desenho do quadro anterior.
+        if (textvertices.size() > textvbo_capacity)
+            textvbo_capacity = textvertices.capacity();
+        RenderStats_BufferData(GL_ARRAY_BUFFER, textvbo_capacity * sizeof(float), NULL, GL_STREAM_DRAW);
+        RenderStats_BufferSubData(GL_ARRAY_BUFFER, 0, textvertices.size() * sizeof(float), textvertices.data());
         glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
 
-        glUseProgram(textprogram_id);
-        glBindVertexArray(textVAO);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-        glDrawArrays(GL_TRIANGLES, 0, 6);
+    glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+    glDepthFunc(GL_ALWAYS);
 
-        glBindVertexArray(0);
-        glUseProgram(0);
-        glDepthFunc(GL_LESS);
+    RenderStats_UseProgram(textprogram_id);
 
-        glDisable(GL_BLEND);
+    if (textretained_vertex_count > 0)
+    {
+        RenderStats_BindVertexArray(textretainedVAO);
+        RenderStats_DrawArrays(GL_TRIANGLES, 0, textretained_vertex_count);
+    }
 
-        x += (glyph->advance_x * sx);
+    if (!textvertices.empty())
+    {
+        RenderStats_BindVertexArray(textVAO);
+        RenderStats_DrawArrays(GL_TRIANGLES, 0, (GLsizei)(textvertices.size() / 4));
     }
+
+    RenderStats_BindVertexArray(0);
+    RenderStats_UseProgram(0);
+    glDepthFunc(GL_LESS);
+
+    glDisable(GL_BLEND);
+
+    textvertices.clear();
 }
 
 float TextRendering_LineHeight(GLFWwindow* window)
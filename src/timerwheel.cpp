@@ -0,0 +1,190 @@
+// Roda de temporizadores hierárquica. Veja "timerwheel.h".
+#include "timerwheel.h"
+
+// Posição (roda e índice) de um evento que vence em "expires", vista do tick
+// "now": a roda é escolhida pela distância até o vencimento, e o índice pelos
+// bits do tick de vencimento correspondentes àquela roda.
+static int TimerWheel_SlotFor(unsigned int now, unsigned int expires)
+{
+    unsigned int delta = expires - now;
+
+    int level = 0;
+    while (level + 1 < TIMERWHEEL_LEVELS && delta >= (1u << (TIMERWHEEL_SLOT_BITS * (level + 1))))
+        ++level;
+
+    // Eventos além da última roda esperam na última posição possível e são
+    // redistribuídos quando ela for visitada
+    unsigned int max_delta = (1u << (TIMERWHEEL_SLOT_BITS * TIMERWHEEL_LEVELS)) - 1u;
+    if (TIMERWHEEL_SLOT_BITS * TIMERWHEEL_LEVELS < 32 && delta > max_delta)
+        expires = now + max_delta;
+
+    int index = (expires >> (TIMERWHEEL_SLOT_BITS * level)) & (TIMERWHEEL_SLOTS - 1);
+    return level * TIMERWHEEL_SLOTS + index;
+}
+
+static void TimerWheel_Link(TimerWheel& wheel, int n)
+{
+    TimerNode& node = wheel.nodes[n];
+    int slot = TimerWheel_SlotFor(wheel.now, node.expires);
+
+    node.slot = slot;
+    node.prev = -1;
+    node.next = wheel.slots[slot];
+    if (node.next >= 0)
+        wheel.nodes[node.next].prev = n;
+    wheel.slots[slot] = n;
+}
+
+static void TimerWheel_Unlink(TimerWheel& wheel, int n)
+{
+    TimerNode& node = wheel.nodes[n];
+
+    if (node.prev >= 0)
+        wheel.nodes[node.prev].next = node.next;
+    else
+        wheel.slots[node.slot] = node.next;
+
+    if (node.next >= 0)
+        wheel.nodes[node.next].prev = node.prev;
+}
+
+// Devolve o nó à lista de livres e invalida os handles dele
+static void TimerWheel_Free(TimerWheel& wheel, int n)
+{
+    TimerNode& node = wheel.nodes[n];
+    node.slot = -1;
+    ++node.generation;
+    if (node.generation == 0)
+        node.generation = 1;
+    node.next = wheel.freeList;
+    wheel.freeList = n;
+    --wheel.count;
+}
+
+void TimerWheel_Reset(TimerWheel& wheel)
+{
+    wheel.now = 0;
+    wheel.slots.assign(TIMERWHEEL_LEVELS * TIMERWHEEL_SLOTS, -1);
+    wheel.freeList = -1;
+    wheel.count = 0;
+
+    for (int n = (int)wheel.nodes.size() - 1; n >= 0; --n)
+    {
+        TimerNode& node = wheel.nodes[n];
+        if (node.slot >= 0)
+        {
+            ++node.generation;
+            if (node.generation == 0)
+                node.generation = 1;
+        }
+        node.slot = -1;
+        node.next = wheel.freeList;
+        wheel.freeList = n;
+    }
+}
+
+TimerHandle TimerWheel_Schedule(TimerWheel& wheel, unsigned int delay, const TimerEvent& event)
+{
+    if (wheel.slots.empty())
+        TimerWheel_Reset(wheel);
+
+    int n = wheel.freeList;
+    if (n >= 0)
+    {
+        wheel.freeList = wheel.nodes[n].next;
+    }
+    else
+    {
+        TimerNode node;
+        node.generation = 1;
+        wheel.nodes.push_back(node);
+        n = (int)wheel.nodes.size() - 1;
+    }
+
+    TimerNode& node = wheel.nodes[n];
+    node.event = event;
+    node.expires = wheel.now + (delay > 0 ? delay : 1);
+    TimerWheel_Link(wheel, n);
+    ++wheel.count;
+
+    TimerHandle handle = { (unsigned int)n, node.generation };
+    return handle;
+}
+
+bool TimerWheel_Cancel(TimerWheel& wheel, TimerHandle handle)
+{
+    if (handle.generation == 0 || handle.node >= wheel.nodes.size())
+        return false;
+
+    TimerNode& node = wheel.nodes[handle.node];
+    if (node.generation != handle.generation || node.slot < 0)
+        return false;
+
+    TimerWheel_Unlink(wheel, (int)handle.node);
+    TimerWheel_Free(wheel, (int)handle.node);
+    return true;
+}
+
+// Redistribui os eventos da posição "slot" nas rodas inferiores
+static void TimerWheel_Cascade(TimerWheel& wheel, int slot)
+{
+    int n = wheel.slots[slot];
+    wheel.slots[slot] = -1;
+
+    while (n >= 0)
+    {
+        int next = wheel.nodes[n].next;
+        TimerWheel_Link(wheel, n);
+        n = next;
+    }
+}
+
+void TimerWheel_Advance(TimerWheel& wheel, unsigned int now, std::vector<TimerEvent>& due)
+{
+    if (wheel.slots.empty())
+        TimerWheel_Reset(wheel);
+
+    while (wheel.now != now)
+    {
+        ++wheel.now;
+
+        // A cada volta completa de uma roda, a posição correspondente da roda
+        // seguinte contém os eventos dos próximos ticks
+        for (int level = 1; level < TIMERWHEEL_LEVELS; ++level)
+        {
+            unsigned int lower_bits = wheel.now & ((1u << (TIMERWHEEL_SLOT_BITS * level)) - 1u);
+            if (lower_bits != 0)
+                break;
+
+            int index = (wheel.now >> (TIMERWHEEL_SLOT_BITS * level)) & (TIMERWHEEL_SLOTS - 1);
+            TimerWheel_Cascade(wheel, level * TIMERWHEEL_SLOTS + index);
+        }
+
+        int slot = wheel.now & (TIMERWHEEL_SLOTS - 1);
+        int n = wheel.slots[slot];
+        wheel.slots[slot] = -1;
+
+        while (n >= 0)
+        {
+            TimerNode& node = wheel.nodes[n];
+            int next = node.next;
+
+            if (node.expires == wheel.now)
+            {
+                due.push_back(node.event);
+                TimerWheel_Free(wheel, n);
+            }
+            else
+            {
+                // Evento além da última roda, ainda não vencido
+                TimerWheel_Link(wheel, n);
+            }
+            n = next;
+        }
+    }
+}
+
+size_t TimerWheel_Count(const TimerWheel& wheel)
+{
+    return wheel.count;
+}